@@ -8,6 +8,8 @@
 #include "NEAT/Config.h"
 #include "NEAT/Genome.h"
 #include "NEAT/Trainer.h"
+#include "NEAT/EvaluationTask.h"
+#include "NEAT/IslandModel.h"
 #include "NEAT/Network.h"
 #include "NEAT/Fitness.h"
 #include "NEAT/Utils.h"
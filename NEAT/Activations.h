@@ -4,11 +4,12 @@
 #include <string>
 #include <stdexcept>
 #include "Math.h"
+#include "Types.h"
 
 namespace NEAT
 {
 	// Enum class for activation functions  
-	enum class EActivation
+	enum class EActivation : uint8
 	{
 		Sigmoid, // Sigmoid function: maps input to a value between 0 and 1, often used in binary classification problems. It has an S-shaped curve and is continuously differentiable.  
 		Tanh, // Hyperbolic tangent function: similar to sigmoid, but maps input to a value between -1 and 1. It is often used in hidden layers of neural networks.  
@@ -0,0 +1,192 @@
+#include "Affinity.h"
+#include "Map.h"
+#include "Math.h"
+#include "Utils.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NEAT
+{
+	namespace
+	{
+		// The cores this process may run on, grouped by NUMA node. Node indices are dense, in the order of the OS node numbers
+		struct Topology
+		{
+			TArray<TArray<int>> NodeCores;
+			TMap<int, int> CoreNodes;
+		};
+
+		thread_local int CurrentNode = 0;
+
+#ifndef _WIN32
+		// Parses a sysfs cpulist such as "0-3,8-11"
+		TArray<int> ParseCoreList(const std::string& CoreList)
+		{
+			TArray<int> Cores;
+			std::stringstream Stream(CoreList);
+			std::string Range;
+			while (std::getline(Stream, Range, ','))
+			{
+				if (Range.empty()) continue;
+				const size_t Dash = Range.find('-');
+				const int First = std::stoi(Range.substr(0, Dash));
+				const int Last = Dash == std::string::npos ? First : std::stoi(Range.substr(Dash + 1));
+				for (int Core = First; Core <= Last; ++Core) Cores.Add(Core);
+			}
+			return Cores;
+		}
+#endif
+
+		Topology DetectTopology()
+		{
+			TMap<int, TArray<int>> CoresByNode; // Keyed by the OS node number
+
+#ifdef _WIN32
+			DWORD_PTR ProcessMask = 0;
+			DWORD_PTR SystemMask = 0;
+			GetProcessAffinityMask(GetCurrentProcess(), &ProcessMask, &SystemMask);
+			for (int Core = 0; Core != int(sizeof(DWORD_PTR) * 8); ++Core)
+			{
+				if (!(ProcessMask & (DWORD_PTR(1) << Core))) continue;
+				UCHAR Node = 0;
+				if (!GetNumaProcessorNode(UCHAR(Core), &Node) || Node == 0xFF) Node = 0;
+				CoresByNode[int(Node)].Add(Core);
+			}
+#else
+			TMap<int, int> SystemNodes;
+			for (int Node = 0; Node != 1024; ++Node) // Node numbers can have gaps, so every possible node is probed
+			{
+				std::ifstream File("/sys/devices/system/node/node" + std::to_string(Node) + "/cpulist");
+				std::string CoreList;
+				if (!File || !std::getline(File, CoreList)) continue;
+				for (int Core : ParseCoreList(CoreList)) SystemNodes[Core] = Node;
+			}
+
+			cpu_set_t Allowed;
+			CPU_ZERO(&Allowed);
+			if (sched_getaffinity(0, sizeof(Allowed), &Allowed) == 0)
+			{
+				for (int Core = 0; Core != CPU_SETSIZE; ++Core)
+				{
+					if (!CPU_ISSET(Core, &Allowed)) continue;
+					const int* Node = SystemNodes.Find(Core);
+					CoresByNode[Node ? *Node : 0].Add(Core);
+				}
+			}
+#endif
+
+			if (CoresByNode.Num() == 0)
+			{
+				for (int Core = 0, NumCores = int(std::thread::hardware_concurrency()); Core < NumCores; ++Core) CoresByNode[0].Add(Core);
+			}
+
+			Topology Result;
+			for (const auto& NodePair : CoresByNode)
+			{
+				const int Node = Result.NodeCores.Num();
+				for (int Core : NodePair.second) Result.CoreNodes[Core] = Node;
+				Result.NodeCores.Add(NodePair.second);
+			}
+			return Result;
+		}
+
+		const Topology& GetTopology()
+		{
+			static const Topology Instance = DetectTopology();
+			return Instance;
+		}
+	}
+
+	int Affinity::GetNumNodes()
+	{
+		return Math::Max(GetTopology().NodeCores.Num(), 1);
+	}
+
+	int Affinity::GetNumCores(int Node)
+	{
+		const auto& NodeCores = GetTopology().NodeCores;
+		return NodeCores.IsValidIndex(Node) ? NodeCores[Node].Num() : 0;
+	}
+
+	int Affinity::GetWorkerCore(EThreadAffinity Affinity, int WorkerIdx, int NumWorkers)
+	{
+		const auto& NodeCores = GetTopology().NodeCores;
+		if (Affinity == EThreadAffinity::None || NodeCores.IsEmpty() || WorkerIdx < 0 || NumWorkers <= 0) return -1;
+
+		if (Affinity == EThreadAffinity::Compact)
+		{
+			int CoreIdx = WorkerIdx % GetTopology().CoreNodes.Num();
+			for (const auto& Cores : NodeCores)
+			{
+				if (CoreIdx < Cores.Num()) return Cores[CoreIdx];
+				CoreIdx -= Cores.Num();
+			}
+			return -1;
+		}
+
+		// Scatter: node N takes the workers in [ceil(N * NumWorkers / NumNodes), ceil((N + 1) * NumWorkers / NumNodes))
+		const int64 NumNodes = NodeCores.Num();
+		const int Node = int(int64(WorkerIdx) * NumNodes / NumWorkers);
+		const int FirstWorker = int((Node * int64(NumWorkers) + NumNodes - 1) / NumNodes);
+		const auto& Cores = NodeCores[Node];
+		return Cores[(WorkerIdx - FirstWorker) % Cores.Num()];
+	}
+
+	bool Affinity::PinCurrentThread(int Core)
+	{
+		if (Core < 0) return false;
+
+#ifdef _WIN32
+		if (Core >= int(sizeof(DWORD_PTR) * 8) || !SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << Core)) return false;
+#else
+		cpu_set_t Set;
+		CPU_ZERO(&Set);
+		CPU_SET(Core, &Set);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set) != 0) return false;
+#endif
+
+		const int* Node = GetTopology().CoreNodes.Find(Core);
+		CurrentNode = Node ? *Node : 0;
+		return true;
+	}
+
+	bool Affinity::PinWorker(EThreadAffinity Affinity, int WorkerIdx, int NumWorkers)
+	{
+		const int Core = GetWorkerCore(Affinity, WorkerIdx, NumWorkers);
+		if (Core < 0) return false;
+		if (PinCurrentThread(Core)) return true;
+
+		LogMessage(LogLevel::Warning, "Failed to pin worker " + std::to_string(WorkerIdx) + " to core " + std::to_string(Core));
+		return false;
+	}
+
+	int Affinity::GetCurrentNode()
+	{
+		return CurrentNode;
+	}
+
+	void Affinity::RunOnNode(int Node, const std::function<void()>& Function)
+	{
+		std::thread Thread([Node, &Function]()
+		{
+			const auto& NodeCores = GetTopology().NodeCores;
+			if (NodeCores.IsValidIndex(Node) && !NodeCores[Node].IsEmpty()) PinCurrentThread(NodeCores[Node][0]);
+			Function();
+		});
+		Thread.join();
+	}
+} // namespace NEAT
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "Types.h"
+#include "Array.h"
+
+// Placement of evaluation worker threads on multi-socket machines.
+// Workers can be pinned to cores (see Config->ThreadAffinity), and read-only training data can be replicated on every NUMA node with TNodeReplicated,
+// so that a pinned worker reads it from memory local to its socket. Machines without NUMA information are treated as a single node.
+
+namespace NEAT
+{
+	enum class EThreadAffinity
+	{
+		None, // Threads are placed by the OS
+		Compact, // Worker N is pinned to core N, filling the cores of one node before the next
+		Scatter, // Workers are spread evenly over the nodes, consecutive workers sharing a node, so that every node gets an equal share of the threads
+	};
+
+	namespace ThreadAffinity
+	{
+		static std::string ToString(EThreadAffinity Affinity)
+		{
+			switch (Affinity)
+			{
+			case EThreadAffinity::None: return "EThreadAffinity::None";
+			case EThreadAffinity::Compact: return "EThreadAffinity::Compact";
+			case EThreadAffinity::Scatter: return "EThreadAffinity::Scatter";
+			default: return "EThreadAffinity::Unknown";
+			}
+		}
+
+		static EThreadAffinity FromString(const std::string& Affinity)
+		{
+			if (Affinity == "EThreadAffinity::None") return EThreadAffinity::None;
+			if (Affinity == "EThreadAffinity::Compact") return EThreadAffinity::Compact;
+			if (Affinity == "EThreadAffinity::Scatter") return EThreadAffinity::Scatter;
+			return EThreadAffinity::None;
+		}
+	}
+
+	namespace Affinity
+	{
+		int GetNumNodes(); // The number of NUMA nodes with cores this process may run on
+		int GetNumCores(int Node); // The number of cores of the node this process may run on
+		int GetWorkerCore(EThreadAffinity Affinity, int WorkerIdx, int NumWorkers); // The core worker WorkerIdx of NumWorkers is pinned to, or -1 when it isn't pinned
+		bool PinCurrentThread(int Core); // Pins the calling thread to a core, returns false if the OS refused
+		bool PinWorker(EThreadAffinity Affinity, int WorkerIdx, int NumWorkers); // Pins the calling worker thread according to Affinity, does nothing for EThreadAffinity::None
+		int GetCurrentNode(); // The node the calling thread was pinned to, 0 for threads that weren't pinned
+		void RunOnNode(int Node, const std::function<void()>& Function); // Runs Function on a thread pinned to the node and waits for it, so that the memory Function touches first is allocated on that node
+	}
+
+	// A copy of read-only data on every NUMA node, each one built by a thread running on its node.
+	// Get returns the copy local to the calling thread, or nullptr when nothing was replicated, in which case callers read the original
+	template<typename T>
+	class TNodeReplicated
+	{
+	public:
+		// Copies Source to every node, on single-node machines nothing is copied
+		void Replicate(const T& Source)
+		{
+			Replicas.Reset();
+			const int NumNodes = Affinity::GetNumNodes();
+			if (NumNodes < 2) return;
+
+			Replicas.SetNum(NumNodes);
+			for (int Node = 0; Node != NumNodes; ++Node)
+			{
+				Affinity::RunOnNode(Node, [this, &Source, Node]() { Replicas[Node] = std::make_shared<T>(Source); });
+			}
+		}
+
+		const T* Get() const
+		{
+			if (Replicas.IsEmpty()) return nullptr;
+			const int Node = Affinity::GetCurrentNode();
+			return Replicas[Replicas.IsValidIndex(Node) ? Node : 0].get();
+		}
+
+		void Reset() { Replicas.Reset(); }
+
+	private:
+		TArray<std::shared_ptr<T>> Replicas;
+	};
+} // namespace NEAT
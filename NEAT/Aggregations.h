@@ -7,10 +7,11 @@
 #include <numeric>
 #include <cmath>
 #include "Array.h"
+#include "Types.h"
 
 namespace NEAT
 {
-	enum class EAggregation 
+	enum class EAggregation : uint8
 	{
 		Mean,
 		Median,
@@ -163,6 +164,7 @@ namespace NEAT
 			case EAggregation::Min: return Min(Values);
 			case EAggregation::Sum: return Sum(Values);
 			case EAggregation::Count: return Count(Values);
+			case EAggregation::Product: return Product(Values);
 			case EAggregation::Variance: return Variance(Values);
 			case EAggregation::StandardDeviation: return StandardDeviation(Values);
 			case EAggregation::Percentile25: return Percentile25(Values);
@@ -0,0 +1,128 @@
+#include "Arena.h"
+#include <atomic>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace NEAT
+{
+	namespace
+	{
+		constexpr size_t ChunkSize = size_t(2) << 20; // One huge page on x86-64
+		constexpr size_t HeaderSize = 16; // Every allocation is preceded by the chunk it came from, keeping 16-byte alignment
+		constexpr size_t MaxArenaAllocation = ChunkSize / 4; // Larger allocations go to the heap, so that chunks aren't mostly wasted
+
+		struct Chunk
+		{
+			std::atomic<int64> NumRefs; // The allocations alive in it, plus one while a thread allocates from it
+		};
+
+		constexpr size_t FirstOffset = (sizeof(Chunk) + HeaderSize - 1) / HeaderSize * HeaderSize;
+
+		std::atomic<bool> bArenaEnabled = false;
+		std::atomic<bool> bArenaHugePages = false;
+		std::atomic<uint64> ArenaEpoch = 0;
+		std::atomic<int64> NumLiveChunks = 0;
+
+		Chunk* NewChunk()
+		{
+			void* Memory = nullptr;
+#ifdef _WIN32
+			Memory = _aligned_malloc(ChunkSize, ChunkSize);
+#else
+			if (posix_memalign(&Memory, ChunkSize, ChunkSize) != 0) Memory = nullptr;
+#ifdef MADV_HUGEPAGE
+			if (Memory && bArenaHugePages.load(std::memory_order_relaxed)) madvise(Memory, ChunkSize, MADV_HUGEPAGE); // A hint, the chunk works either way
+#endif
+#endif
+			if (!Memory) throw std::bad_alloc();
+
+			NumLiveChunks.fetch_add(1, std::memory_order_relaxed);
+			return new (Memory) Chunk{ { 1 } };
+		}
+
+		void ReleaseRef(Chunk* Released)
+		{
+			if (!Released || Released->NumRefs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+			Released->~Chunk();
+#ifdef _WIN32
+			_aligned_free(Released);
+#else
+			free(Released);
+#endif
+			NumLiveChunks.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		// The chunk the calling thread allocates from, retired when the thread exits
+		struct ThreadChunk
+		{
+			Chunk* Current = nullptr;
+			size_t Offset = 0;
+			uint64 Epoch = 0;
+
+			~ThreadChunk() { ReleaseRef(Current); }
+		};
+
+		thread_local ThreadChunk CurrentChunk;
+	}
+
+	void GenerationArena::Configure(bool bEnabled, bool bHugePages)
+	{
+		bArenaEnabled = bEnabled;
+		bArenaHugePages = bHugePages;
+	}
+
+	void GenerationArena::BeginGeneration()
+	{
+		ArenaEpoch.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void* GenerationArena::Allocate(size_t Size)
+	{
+		const size_t AllocationSize = HeaderSize + (Size + HeaderSize - 1) / HeaderSize * HeaderSize;
+		if (!bArenaEnabled.load(std::memory_order_relaxed) || AllocationSize > MaxArenaAllocation)
+		{
+			void* Memory = malloc(AllocationSize);
+			if (!Memory) throw std::bad_alloc();
+			*static_cast<Chunk**>(Memory) = nullptr;
+			return static_cast<uint8*>(Memory) + HeaderSize;
+		}
+
+		ThreadChunk& Thread = CurrentChunk;
+		const uint64 Epoch = ArenaEpoch.load(std::memory_order_relaxed);
+		if (!Thread.Current || Thread.Epoch != Epoch || Thread.Offset + AllocationSize > ChunkSize)
+		{
+			ReleaseRef(Thread.Current); // Retired, released once its allocations are freed
+			Thread.Current = nullptr;
+			Thread.Current = NewChunk();
+			Thread.Offset = FirstOffset;
+			Thread.Epoch = Epoch;
+		}
+
+		uint8* Memory = reinterpret_cast<uint8*>(Thread.Current) + Thread.Offset;
+		Thread.Offset += AllocationSize;
+		Thread.Current->NumRefs.fetch_add(1, std::memory_order_relaxed);
+		*reinterpret_cast<Chunk**>(Memory) = Thread.Current;
+		return Memory + HeaderSize;
+	}
+
+	void GenerationArena::Free(void* Memory)
+	{
+		if (!Memory) return;
+
+		uint8* Allocation = static_cast<uint8*>(Memory) - HeaderSize;
+		Chunk* Owner = *reinterpret_cast<Chunk**>(Allocation);
+		if (!Owner) free(Allocation);
+		else ReleaseRef(Owner);
+	}
+
+	int64 GenerationArena::GetNumChunks()
+	{
+		return NumLiveChunks.load(std::memory_order_relaxed);
+	}
+} // namespace NEAT
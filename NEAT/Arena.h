@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include "Types.h"
+
+// Generation-scoped arena for genomes, their genes and the networks built from them (see Config->GenerationArena).
+// Each thread carves its allocations out of its own chunk, and starts a new chunk once the trainer begins a generation. A chunk counts the allocations still alive in it
+// and is released in one piece once the last of them is freed, so the memory of a retired generation goes back to the system in whole chunks instead of gene by gene.
+// Genomes that survive their generation, such as elites, keep only their own chunk alive. Chunks are the size of a huge page and can be backed by one.
+// The arena is shared by every trainer in the process. While it is disabled, allocations go to the heap.
+
+namespace NEAT
+{
+	namespace GenerationArena
+	{
+		void Configure(bool bEnabled, bool bHugePages); // Takes effect for allocations made from then on, memory already handed out stays valid
+		void BeginGeneration(); // Retires the chunks threads allocate from, they are released once everything allocated in them was freed
+		void* Allocate(size_t Size); // 16-byte aligned
+		void Free(void* Memory);
+		int64 GetNumChunks(); // The number of chunks not yet released
+	}
+
+	// Stateless allocator for the arena, usable with standard containers and std::allocate_shared
+	template<typename T>
+	struct TArenaAllocator
+	{
+		using value_type = T;
+
+		static_assert(alignof(T) <= 16, "The arena only aligns to 16 bytes");
+
+		TArenaAllocator() noexcept = default;
+		template<typename U> TArenaAllocator(const TArenaAllocator<U>&) noexcept {}
+
+		T* allocate(size_t Num) { return static_cast<T*>(GenerationArena::Allocate(Num * sizeof(T))); }
+		void deallocate(T* Memory, size_t) noexcept { GenerationArena::Free(Memory); }
+
+		template<typename U> bool operator==(const TArenaAllocator<U>&) const noexcept { return true; }
+		template<typename U> bool operator!=(const TArenaAllocator<U>&) const noexcept { return false; }
+	};
+
+	template<typename T, typename... Args>
+	std::shared_ptr<T> MakeArenaShared(Args&&... InArgs) // std::make_shared in the arena, the object and its reference count share one allocation
+	{
+		return std::allocate_shared<T>(TArenaAllocator<T>(), std::forward<Args>(InArgs)...);
+	}
+} // namespace NEAT
@@ -135,7 +135,9 @@ public:
 	TMap<std::string, FStockData> InputStockData;
 	TMap<std::string, FStockData> RawPriceData;
 	TMap<std::string, FInputData> InputData;
+	NEAT::TNodeReplicated<TMap<std::string, FInputData>> InputDataReplicas; // Only used with Config->NumaReplication, a copy of InputData on every NUMA node
 	TMap<std::string, double> OutputPercentChanges;
+	TArray<double> RemainingMaxScores; // The best score still obtainable from each input date to the end, the upper bound reported to the trainer
 
 	TMap<std::string, TArray<double>> ParseCSV(const std::string& Filepath) const
 	{
@@ -295,6 +297,59 @@ public:
 		}
 	}
 
+	void PopulateRemainingMaxScores()
+	{
+		const auto& Dates = InputData.GetKeys();
+		RemainingMaxScores.SetNum(Dates.Num() + 1, 0.0);
+		for (int Idx = Dates.Num() - 1; Idx >= 0; --Idx)
+		{
+			const double* PercentChange = OutputPercentChanges.Find(Dates[Idx]);
+			double MaxScore = 0.0;
+			if (PercentChange)
+			{
+				for (EStockAction Action : { EStockAction::StrongBuy, EStockAction::Buy, EStockAction::Hold, EStockAction::Sell, EStockAction::StrongSell })
+				{
+					MaxScore = NEAT::Math::Max(MaxScore, ScorePrediction(Action, *PercentChange));
+				}
+			}
+			RemainingMaxScores[Idx] = RemainingMaxScores[Idx + 1] + MaxScore;
+		}
+	}
+
+	// The fitness awarded for taking Action on a day whose price then moved by PercentChange
+	static double ScorePrediction(EStockAction Action, double PercentChange)
+	{
+		if (PercentChange > 0.0) // If the stock price increased
+		{
+			if (Action == EStockAction::Buy || Action == EStockAction::StrongBuy) // If the prediction was to buy
+			{
+				bool bCorrectStrength = (Action == EStockAction::StrongBuy) && (PercentChange > StrongIndicatorThreshold);
+				double StrengthMultiplier = bCorrectStrength ? 2.0 : 1.0;
+				return (StrengthMultiplier * PercentChange);
+			}
+			else if (Action == EStockAction::Sell || Action == EStockAction::StrongSell) // If the prediction was to sell
+			{
+				double StrengthMultiplier = (Action == EStockAction::StrongSell) ? 2.0 : 1.0;
+				return -(StrengthMultiplier * PercentChange);
+			}
+		}
+		else if (PercentChange < 0.0)
+		{
+			if (Action == EStockAction::Sell || Action == EStockAction::StrongSell) // If the prediction was to sell
+			{
+				bool bCorrectStrength = (Action == EStockAction::StrongSell) && (PercentChange < -StrongIndicatorThreshold);
+				double StrengthMultiplier = bCorrectStrength ? 2.0 : 1.0;
+				return (StrengthMultiplier * PercentChange);
+			}
+			else if (Action == EStockAction::Buy || Action == EStockAction::StrongBuy) // If the prediction was to buy
+			{
+				double StrengthMultiplier = (Action == EStockAction::StrongBuy) ? 2.0 : 1.0;
+				return -(StrengthMultiplier * PercentChange);
+			}
+		}
+		return 0.0;
+	}
+
 	void Initialize() override
 	{
 		Super::Initialize();
@@ -304,6 +359,8 @@ public:
 		
 		PopulateInputData();
 		PopulateOutputData();
+		PopulateRemainingMaxScores();
+		if (Config->NumaReplication) InputDataReplicas.Replicate(InputData);
 
 		// Double check that the number of inputs matches the number of outputs
 		if (InputData.Num() != OutputPercentChanges.Num()) NEAT::LogMessage(NEAT::LogLevel::Error, "The number of inputs does not match the number of outputs."); return;
@@ -320,57 +377,22 @@ public:
 		NEAT::NeuralNetworkPtr Network = Genome->CreateNeuralNetwork();
 		if (!Network) return 0.0;
 
-		const auto& Dates = InputData.GetKeys();
-
-		TArray<double> Predictions;
-		Predictions.Reserve(Dates.Num());
+		const auto* ReplicatedInputData = InputDataReplicas.Get(); // The copy on the evaluating thread's node, if the data was replicated
+		const auto& LocalInputData = ReplicatedInputData ? *ReplicatedInputData : InputData;
+		const auto& Dates = LocalInputData.GetKeys();
+		const bool bHasBounds = RemainingMaxScores.Num() == Dates.Num() + 1;
 
-		FInputData CurrentInput;
+		// Score each day as soon as its prediction is made, so that hopeless genomes can be cut short
+		double Fitness = 0.0;
 		for (auto CurrentDateIdx = 0, StopIdx = Dates.Num(); CurrentDateIdx != StopIdx; ++CurrentDateIdx)
 		{
 			const auto& CurrentDate = Dates[CurrentDateIdx];
-			const auto& Inputs = InputData[CurrentDate];
+			const auto& Inputs = *LocalInputData.Find(CurrentDate);
 			const auto Outputs = Network->Evaluate(Inputs.ToArray());
 			double Prediction = Outputs.IsValidIndex(0) ? Outputs[0] : 0.0;
-			Predictions.Add(Prediction);
-		}
+			Fitness += ScorePrediction(StockAction::FromDouble(Prediction), OutputPercentChanges[CurrentDate]);
 
-		double Fitness = 0.0;
-		for (int PredictionIdx = 0, StopIdx = Predictions.Num(); PredictionIdx != StopIdx; ++PredictionIdx)
-		{
-			const auto& CurrentDate = Dates[PredictionIdx];
-			const auto& CurrentPrediction = Predictions[PredictionIdx];
-			const auto& CurrentPercentChange = OutputPercentChanges[CurrentDate];
-			const auto& CurrentAction = StockAction::FromDouble(CurrentPrediction);
-
-			if (CurrentPercentChange > 0.0) // If the stock price increased
-			{
-				if (CurrentAction == EStockAction::Buy || CurrentAction == EStockAction::StrongBuy) // If the prediction was to buy
-				{
-					bool bCorrectStrength = (CurrentAction == EStockAction::StrongBuy) && (CurrentPercentChange > StrongIndicatorThreshold);
-					double StrengthMultiplier = bCorrectStrength ? 2.0 : 1.0;
-					Fitness += (StrengthMultiplier * CurrentPercentChange);
-				}
-				else if (CurrentAction == EStockAction::Sell || CurrentAction == EStockAction::StrongSell) // If the prediction was to sell
-				{
-					double StrengthMultiplier = (CurrentAction == EStockAction::StrongSell) ? 2.0 : 1.0;
-					Fitness -= (StrengthMultiplier * CurrentPercentChange);
-				}
-			}
-			else if (CurrentPercentChange < 0.0)
-			{
-				if (CurrentAction == EStockAction::Sell || CurrentAction == EStockAction::StrongSell) // If the prediction was to sell
-				{
-					bool bCorrectStrength = (CurrentAction == EStockAction::StrongSell) && (CurrentPercentChange < -StrongIndicatorThreshold);
-					double StrengthMultiplier = bCorrectStrength ? 2.0 : 1.0;
-					Fitness += (StrengthMultiplier * CurrentPercentChange);
-				}
-				else if (CurrentAction == EStockAction::Buy || CurrentAction == EStockAction::StrongBuy) // If the prediction was to buy
-				{
-					double StrengthMultiplier = (CurrentAction == EStockAction::StrongBuy) ? 2.0 : 1.0;
-					Fitness -= (StrengthMultiplier * CurrentPercentChange);
-				}
-			}
+			if (bHasBounds && !ReportPartialFitness(Fitness, Fitness + RemainingMaxScores[CurrentDateIdx + 1])) break;
 		}
 
 		return Fitness;
@@ -1,11 +1,15 @@
 #include "config.h"  
 #include <fstream>  
 #include <sstream>  
+#include <thread>
 
 namespace NEAT {
 
 	// Constructor  
-	Config::Config() { }
+	Config::Config()
+	{
+		PrepareMutationTables();
+	}
 
 	// Load configuration from file  
 	void Config::LoadFromFile(const std::string& Filename) 
@@ -19,4 +23,25 @@ namespace NEAT {
 		
 	}
 
+	int Config::GetNumThreads() const
+	{
+		if (NumThreads > 0) return NumThreads;
+		const int HardwareThreads = int(std::thread::hardware_concurrency());
+		return HardwareThreads > 0 ? HardwareThreads : 1;
+	}
+
+	void Config::PrepareMutationTables()
+	{
+		auto Tables = std::make_shared<MutationTables>();
+		Tables->Activations = SupportedActivationFunctions;
+		Tables->Activations.AddUnique(DefaultActivationFunction);
+		Tables->Aggregations = SupportedAggregationFunctions;
+		Tables->Aggregations.AddUnique(DefaultAggregationFunction);
+
+		// Trainers sharing a config prepare it as they initialize, possibly while others already mutate from it, so the tables are swapped in whole and only when they change
+		const auto Current = GetMutationTables();
+		if (Current && Current->Activations.GetArray() == Tables->Activations.GetArray() && Current->Aggregations.GetArray() == Tables->Aggregations.GetArray()) return;
+		PublishedMutationTables.Tables.store(std::move(Tables), std::memory_order_release);
+	}
+
 } // namespace NEAT
\ No newline at end of file
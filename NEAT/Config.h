@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include "Types.h"
@@ -7,6 +8,8 @@
 #include "Activations.h"
 #include "Aggregations.h"
 #include "Reproduction.h"
+#include "IslandModel.h"
+#include "Affinity.h"
 
 // This configuration file is the central hub for a NeuroEvolution of Augmenting Topologies(NEAT) algorithm implementation.
 // It defines the core parameters and settings that govern the behavior of the NEAT algorithm, including the structure of the neural networks, the evolutionary process, and the fitness evaluation.
@@ -50,7 +53,66 @@ namespace NEAT
 		bool ResetNetworkActivations = true;
 
 		int MultithreadedEvaluation = 1;
-		int NumThreads = 16;
+
+		// Number of threads: The most threads a parallel phase uses. Zero uses one thread per hardware thread of the host, see GetNumThreads.
+		int NumThreads = 0;
+
+		// Adaptive parallelism: When enabled, the trainer measures the cost of each parallel phase as it runs and picks the thread count and chunk size of its next run from it, running phases serially when they are too small to pay for the threads. When disabled, every phase uses all NumThreads threads.
+		bool AdaptiveParallelism = true;
+
+		// Parallel grain: The estimated work, in microseconds, each thread of a parallel phase should get at least. Lower values use more threads for small phases.
+		int ParallelGrainMicroseconds = 500;
+
+		// Thread affinity: How evaluation and steady-state worker threads are pinned to cores. Compact fills the cores of one NUMA node before the next, Scatter spreads the workers evenly over the nodes so that every node gets an equal share of the threads. None leaves placement to the OS.
+		EThreadAffinity ThreadAffinity = EThreadAffinity::None;
+
+		// NUMA replication: When enabled, trainers that support it keep a copy of their read-only training data on every NUMA node (see TNodeReplicated), so that pinned workers read it from local memory. Has no effect on single-node machines.
+		bool NumaReplication = false;
+
+		// Generation arena: When enabled, genomes, their genes and their networks are allocated from large per-thread chunks that are handed back as a whole once everything allocated from them is gone, instead of one heap allocation each. The arena is shared by every trainer in the process, so one trainer enabling it turns it on for all of them.
+		bool GenerationArena = false;
+
+		// Arena huge pages: When enabled, arena chunks ask the OS to back them with huge pages, cutting TLB misses on large populations. A hint that is only given on POSIX systems with transparent huge pages.
+		bool ArenaHugePages = false;
+
+		// Evaluation batch size: The number of genomes handed to Trainer::EvaluateBatch at once. Evaluation threads claim batches of this size until the population is evaluated. Zero sizes the batches from the population size and NumThreads, so that the batches of an overridden EvaluateBatch, and its results, don't depend on timing. The default EvaluateBatch gives each genome its own random stream, so for it zero uses the chunk size measured for the evaluation phase instead (see AdaptiveParallelism).
+		int EvaluationBatchSize = 0;
+
+		// Pipelined reproduction: When enabled, each offspring is bred, mutated and evaluated by one worker task straight after selection, while its genes are still in cache, instead of in separate passes over the whole population. Offspring draw from their own random streams, so runs differ from unpipelined ones with the same seed. Only applies to local thread evaluation; surviving parents are mutated and evaluated as usual.
+		bool PipelinedReproduction = false;
+
+		// Steady-state evolution: When enabled, training runs in real-time (rtNEAT-style) mode, where worker threads continuously breed, evaluate and insert single offspring in place of low-ranked genomes, instead of stepping whole generations behind a barrier. Offspring are evaluated one at a time through Trainer::Evaluate, with fitness caching and EarlyTerminationBelowBest; EvaluateBatch, EvaluateAsync and the species survival cutoffs of EarlyTermination are generational only.
+		bool SteadyStateEvolution = false;
+
+		// Steady-state generation length: The number of offspring inserted in steady-state mode that count as one generation, for stagnation, reproduction counts and reporting. Zero uses the population size.
+		int SteadyStateGenerationLength = 0;
+
+		// Early termination: When enabled, evaluations that report their progress through Trainer::ReportPartialFitness are aborted once their optimistic upper bound can't reach the survival cutoff of their species, the fitness of the last genome elitism culling would keep. Only applies to generational training with ECullingMethod::Elitism. Which genomes are cut short depends on the order in which evaluations finish.
+		bool EarlyTermination = false;
+
+		// Early termination below best: Also abort evaluations whose upper bound can't beat the best genome found so far. Useful when only the champion matters, at the cost of coarser fitness values for the rest of the population.
+		bool EarlyTerminationBelowBest = false;
+
+		// Fitness caching: When enabled, genomes identical to one evaluated before (elites, unmutated clones, migrants) reuse its fitness instead of being evaluated again. Identity is decided by Genotype::GetFullHash. Only enable this for deterministic fitness functions.
+		bool FitnessCaching = false;
+
+		// Fitness cache size: The number of cached fitness values above which entries that weren't used in the last generation are dropped.
+		int FitnessCacheSize = 100000;
+
+		// Fitness store file: The file fitness values are kept in across runs, so that genomes scored by an earlier run with the same FitnessStoreVersion are looked up before Evaluate is called. Empty disables the store. Implies fitness caching. POSIX only.
+		std::string FitnessStoreFile = "";
+
+		// Fitness store version: A tag naming the dataset and fitness function the stored values belong to. Fitness values stored under another tag are ignored, so change it whenever Evaluate or its data changes.
+		std::string FitnessStoreVersion = "";
+
+		// Fitness store capacity: The number of fitness values the store file has room for, decided by the run that creates it.
+		int FitnessStoreCapacity = 1 << 22;
+
+		// Asynchronous evaluation: When enabled, genomes are evaluated through Trainer::EvaluateAsync coroutines. Each evaluation thread keeps many evaluations in flight, steps all of them to their next network query and then answers the pending queries together, so that environment stepping and inference are done in batches. Trainers that don't override EvaluateAsync evaluate as usual.
+		bool AsyncEvaluation = false;
+
+		// Async concurrency: The number of coroutine evaluations kept in flight at once, split evenly over the evaluation threads.
+		int AsyncConcurrency = 1024;
 
 		bool ReintroduceBestGenome = true;
 		int ReintroductionPeriod = 25;
@@ -131,6 +193,9 @@ namespace NEAT
 		// Add connection mutation rate: The rate at which new connections are added to the neural network during evolution. A higher value allows for more complex solutions but may increase computational cost.  
 		double AddConnectionMutationRate = 0.08;
 
+		// Feed-forward: When enabled, add connection mutations never create a connection that closes a cycle, including connections from a node to itself. This costs a search of the nodes downstream of the new connection for each attempt.
+		bool FeedForward = false;
+
 		// Remove neuron mutation rate: The rate at which neurons are removed from the neural network during evolution. A higher value allows for simpler solutions but may not be sufficient for complex problems.  
 		double RemoveConnectionMutationRate = 0.01;
 
@@ -224,6 +289,64 @@ namespace NEAT
 		// Pairing method: The method used to pair surviving genomes together for crossover reproduction
 		EGenomePairing PairingMethod = EGenomePairing::Random;
 
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Island model settings  
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		// Number of islands: The number of sub-populations evolved in parallel by IslandModel, each on its own thread with its own species, innovations and random stream. PopulationSize is split evenly between them.
+		int NumIslands = 4;
+
+		// Migration interval: The number of generations between migrations. Zero disables migration and keeps the islands fully isolated.
+		int MigrationInterval = 10;
+
+		// Migration size: The number of elite genomes each island sends along every route of the migration topology.
+		int MigrationSize = 2;
+
+		// Migration topology: The routes migrants travel between islands. A ring preserves diversity longer, all-to-all spreads good solutions faster.
+		EMigrationTopology MigrationTopology = EMigrationTopology::Ring;
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Process evaluation settings  
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		// Process evaluation: When enabled, genomes are evaluated by forked worker processes that exchange genomes and fitness values with the trainer through shared memory. Use this for Evaluate code that isn't thread-safe. POSIX only, other platforms keep evaluating with threads.
+		bool ProcessEvaluation = false;
+
+		// Number of processes: The number of worker processes forked for process evaluation.
+		int NumProcesses = 8;
+
+		// Process slot size: The number of bytes reserved per shared-memory slot for a genome's binary encoding. Genomes that don't fit are evaluated by the trainer process itself.
+		int ProcessSlotSize = 65536;
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Shared innovation settings  
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		// Shared innovations: The name of a shared-memory segment that trainer processes on the same host number their innovations in, so that every process gives the same ID to the same structural innovation and genomes can be exchanged between them. Empty keeps the numbering private to the trainer. POSIX only.
+		std::string SharedInnovations = "";
+
+		// Shared innovation capacity: The number of innovations the shared segment has room for, decided by the process that creates it. Innovations found once it is full are numbered by each process on its own.
+		int SharedInnovationCapacity = 1 << 20;
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Distributed evaluation settings  
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		// Distributed evaluation: When enabled, the trainer listens on DistributedPort and evaluates genomes on worker processes connected over TCP (see Trainer::RunWorker), evaluating locally whenever no worker is connected.
+		bool DistributedEvaluation = false;
+
+		// Distributed port: The TCP port the coordinator listens on for worker connections.
+		int DistributedPort = 31370;
+
+		// Distributed batch size: The number of genomes sent to a worker per request. Larger batches amortize network round trips, smaller batches balance the load better.
+		int DistributedBatchSize = 8;
+
+		// Distributed straggler timeout: The number of seconds a task may run on one worker before an idle worker is given a backup copy of it. The first result received wins.
+		double DistributedStragglerTimeout = 2.0;
+
+		// Distributed worker wait: The number of seconds the coordinator waits for a worker to connect before evaluating the remaining genomes locally.
+		double DistributedWorkerWait = 10.0;
+
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		// Logging settings  
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -249,10 +372,39 @@ namespace NEAT
 		// Save configuration to file  
 		void SaveToFile(const std::string& Filename);
 
+		// Returns NumThreads, or the hardware concurrency of the host when NumThreads is zero
+		int GetNumThreads() const;
+
+		// The functions activation and aggregation mutations pick from: the supported functions, plus the default one so that there is always one to pick
+		struct MutationTables
+		{
+			TArray<EActivation> Activations;
+			TArray<EAggregation> Aggregations;
+		};
+
+		// Rebuilds the mutation tables out of the settings above. The constructor and Trainer::Initialize call it, call it again after changing the supported or default functions during a run
+		void PrepareMutationTables();
+
+		// Returns the current mutation tables. They are never changed once published, PrepareMutationTables swaps in new ones, so mutations on other threads keep reading the tables they loaded
+		std::shared_ptr<const MutationTables> GetMutationTables() const { return PublishedMutationTables.Tables.load(std::memory_order_acquire); }
+
 		static ConfigPtr CreateDefaultConfig() 
 		{
 			return std::make_shared<Config>();
 		}
+
+	private:
+		// Holds the published mutation tables, copyable so that configs can still be copied
+		struct MutationTablesSlot
+		{
+			std::atomic<std::shared_ptr<const MutationTables>> Tables;
+
+			MutationTablesSlot() = default;
+			MutationTablesSlot(const MutationTablesSlot& Other) : Tables(Other.Tables.load(std::memory_order_acquire)) { }
+			MutationTablesSlot& operator=(const MutationTablesSlot& Other) { Tables.store(Other.Tables.load(std::memory_order_acquire), std::memory_order_release); return *this; }
+		};
+
+		MutationTablesSlot PublishedMutationTables;
 	};
 
 	//using ConfigPtr = std::shared_ptr<const NEAT::Config>;
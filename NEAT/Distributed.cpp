@@ -0,0 +1,556 @@
+#include "Distributed.h"
+#include "Trainer.h"
+#include "Genome.h"
+#include "Config.h"
+#include "Random.h"
+#include "Utils.h"
+#include "Math.h"
+#include <chrono>
+#include <deque>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NEAT {
+namespace Distributed {
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr uint32 ProtocolVersion = 1;
+	constexpr uint32 MaxMessageSize = 256u << 20; // Anything larger is treated as a corrupt stream
+
+#ifdef _WIN32
+	using PollDescriptor = WSAPOLLFD;
+	const SocketHandle InvalidSocket = SocketHandle(INVALID_SOCKET);
+	constexpr int SendFlags = 0;
+	int PollSockets(PollDescriptor* Descriptors, size_t Num, int TimeoutMs) { return WSAPoll(Descriptors, ULONG(Num), TimeoutMs); }
+	void CloseSocket(SocketHandle Socket) { closesocket(SOCKET(Socket)); }
+	void SetNonBlocking(SocketHandle Socket) { u_long Mode = 1; ioctlsocket(SOCKET(Socket), FIONBIO, &Mode); }
+#else
+	using PollDescriptor = pollfd;
+	const SocketHandle InvalidSocket = -1;
+#ifdef MSG_NOSIGNAL
+	constexpr int SendFlags = MSG_NOSIGNAL; // A worker dying mid-send must not raise SIGPIPE in the coordinator
+#else
+	constexpr int SendFlags = 0;
+#endif
+	int PollSockets(PollDescriptor* Descriptors, size_t Num, int TimeoutMs) { return poll(Descriptors, nfds_t(Num), TimeoutMs); }
+	void CloseSocket(SocketHandle Socket) { close(Socket); }
+	void SetNonBlocking(SocketHandle Socket) { fcntl(Socket, F_SETFL, fcntl(Socket, F_GETFL, 0) | O_NONBLOCK); }
+#endif
+
+	bool InitializeSockets()
+	{
+#ifdef _WIN32
+		static bool bInitialized = []() { WSADATA Data; return WSAStartup(MAKEWORD(2, 2), &Data) == 0; }();
+		return bInitialized;
+#else
+		return true;
+#endif
+	}
+
+	void SetNoDelay(SocketHandle Socket)
+	{
+		int Enable = 1;
+		setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&Enable), sizeof(Enable));
+	}
+
+	bool SendAll(SocketHandle Socket, const uint8* Data, size_t Size)
+	{
+		while (Size > 0)
+		{
+			auto Sent = send(Socket, reinterpret_cast<const char*>(Data), int(Math::Min<size_t>(Size, 1u << 30)), SendFlags);
+			if (Sent <= 0) return false;
+			Data += Sent;
+			Size -= size_t(Sent);
+		}
+		return true;
+	}
+
+	bool ReceiveAll(SocketHandle Socket, uint8* Data, size_t Size)
+	{
+		while (Size > 0)
+		{
+			auto Received = recv(Socket, reinterpret_cast<char*>(Data), int(Math::Min<size_t>(Size, 1u << 30)), 0);
+			if (Received <= 0) return false;
+			Data += Received;
+			Size -= size_t(Received);
+		}
+		return true;
+	}
+
+	// Messages are framed as [uint32 Length][uint8 Type][Payload], where Length counts the type byte and the payload
+	bool SendPacket(SocketHandle Socket, EMessageType Type, const std::vector<uint8>& Payload)
+	{
+		std::vector<uint8> Packet;
+		Packet.reserve(Payload.size() + sizeof(uint32) + 1);
+		WriteBinary(Packet, uint32(Payload.size() + 1));
+		WriteBinary(Packet, uint8(Type));
+		Packet.insert(Packet.end(), Payload.begin(), Payload.end());
+		return SendAll(Socket, Packet.data(), Packet.size());
+	}
+
+	double SecondsSince(Clock::time_point Start)
+	{
+		return std::chrono::duration<double>(Clock::now() - Start).count();
+	}
+}
+
+struct Coordinator::EvaluationState
+{
+	const TArray<GenomePtr>* Genomes = nullptr;
+	unsigned Generation = 0;
+	std::vector<std::vector<uint8>> Payloads; // Serialized genotypes, built once and reused by retries and re-dispatches
+	std::vector<uint8> bDone;
+	std::vector<int> InFlightCopies; // How many workers are currently evaluating each task
+	std::vector<Clock::time_point> DispatchTimes;
+	std::deque<int> Pending;
+	int NumDone = 0;
+};
+
+Coordinator::Coordinator(const ConfigPtr& InConfig)
+	: Config(InConfig)
+	, ListenSocket(InvalidSocket)
+{
+}
+
+Coordinator::~Coordinator()
+{
+	Shutdown();
+}
+
+bool Coordinator::Listen(int Port)
+{
+	if (!InitializeSockets())
+	{
+		LogMessage(LogLevel::Error, "Distributed: failed to initialize sockets");
+		return false;
+	}
+
+	ListenSocket = SocketHandle(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (ListenSocket == InvalidSocket)
+	{
+		LogMessage(LogLevel::Error, "Distributed: failed to create the listen socket");
+		return false;
+	}
+
+	int Reuse = 1;
+	setsockopt(ListenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&Reuse), sizeof(Reuse));
+
+	sockaddr_in Address = {};
+	Address.sin_family = AF_INET;
+	Address.sin_addr.s_addr = htonl(INADDR_ANY);
+	Address.sin_port = htons(uint16(Port));
+	if (bind(ListenSocket, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 || listen(ListenSocket, SOMAXCONN) != 0)
+	{
+		LogMessage(LogLevel::Error, "Distributed: failed to listen on port " + std::to_string(Port));
+		CloseSocket(ListenSocket);
+		ListenSocket = InvalidSocket;
+		return false;
+	}
+
+	SetNonBlocking(ListenSocket);
+	bListening = true;
+	LogMessage(LogLevel::Info, "Distributed: coordinator listening on port " + std::to_string(Port));
+	return true;
+}
+
+int Coordinator::GetNumWorkers() const
+{
+	return Workers.CountByPredicate([](const WorkerConnectionPtr& Worker) { return Worker->bAlive; });
+}
+
+void Coordinator::AcceptWorkers()
+{
+	while (bListening)
+	{
+		SocketHandle Socket = SocketHandle(accept(ListenSocket, nullptr, nullptr));
+		if (Socket == InvalidSocket) return; // Nothing left to accept (or a transient error), try again on the next poll
+
+		SetNoDelay(Socket);
+		auto Worker = std::make_shared<WorkerConnection>();
+		Worker->Socket = Socket;
+		Workers.Add(Worker);
+		LogMessage(LogLevel::Info, "Distributed: worker connected (" + std::to_string(GetNumWorkers()) + " active)");
+	}
+}
+
+void Coordinator::DropWorker(WorkerConnection& Worker, EvaluationState* State)
+{
+	if (!Worker.bAlive) return;
+	Worker.bAlive = false;
+	CloseSocket(Worker.Socket);
+
+	// Requeue the worker's batch at the front of the queue, unless another worker is still running a copy of a task
+	if (State && Worker.InFlightGeneration == State->Generation)
+	{
+		for (int Idx = Worker.InFlight.Num() - 1; Idx >= 0; --Idx)
+		{
+			int TaskIdx = Worker.InFlight[Idx];
+			if (--State->InFlightCopies[TaskIdx] == 0 && !State->bDone[TaskIdx]) State->Pending.push_front(TaskIdx);
+		}
+	}
+	Worker.InFlight.Reset();
+	LogMessage(LogLevel::Warning, "Distributed: worker disconnected (" + std::to_string(GetNumWorkers()) + " active)");
+}
+
+bool Coordinator::DispatchBatch(WorkerConnection& Worker, EvaluationState& State)
+{
+	const int BatchSize = Math::Max(Config->DistributedBatchSize, 1);
+	TArray<int> Batch;
+	while (Batch.Num() < BatchSize && !State.Pending.empty())
+	{
+		int TaskIdx = State.Pending.front();
+		State.Pending.pop_front();
+		if (!State.bDone[TaskIdx]) Batch.Add(TaskIdx);
+	}
+
+	// With nothing queued, back up the oldest tasks that have been outstanding for longer than the straggler timeout on a single worker
+	if (Batch.IsEmpty())
+	{
+		TArray<int> Stragglers;
+		for (int TaskIdx = 0, NumTasks = int(State.bDone.size()); TaskIdx != NumTasks; ++TaskIdx)
+		{
+			if (State.bDone[TaskIdx] || State.InFlightCopies[TaskIdx] != 1) continue;
+			if (SecondsSince(State.DispatchTimes[TaskIdx]) < Config->DistributedStragglerTimeout) continue;
+			Stragglers.Add(TaskIdx);
+		}
+		Stragglers.Sort([&State](int A, int B) { return State.DispatchTimes[A] < State.DispatchTimes[B]; });
+		Batch = Stragglers.First(BatchSize);
+	}
+
+	if (Batch.IsEmpty()) return false;
+
+	std::vector<uint8> Payload;
+	WriteBinary(Payload, uint32(State.Generation));
+	WriteBinary(Payload, uint32(Batch.Num()));
+	for (int TaskIdx : Batch)
+	{
+		const auto& Genome = (*State.Genomes)[TaskIdx];
+		WriteBinary(Payload, uint32(TaskIdx));
+		WriteBinary(Payload, uint64(Genome->ID));
+		WriteBinary(Payload, uint64(Genome->SpeciesID));
+		Payload.insert(Payload.end(), State.Payloads[TaskIdx].begin(), State.Payloads[TaskIdx].end());
+	}
+
+	if (!SendPacket(Worker.Socket, EMessageType::EvaluateBatch, Payload))
+	{
+		DropWorker(Worker, &State);
+		return false;
+	}
+
+	auto Now = Clock::now();
+	for (int TaskIdx : Batch)
+	{
+		State.InFlightCopies[TaskIdx]++;
+		State.DispatchTimes[TaskIdx] = Now;
+	}
+	Worker.InFlight = Batch;
+	Worker.InFlightGeneration = State.Generation;
+	return true;
+}
+
+void Coordinator::ProcessMessages(WorkerConnection& Worker, EvaluationState* State)
+{
+	size_t Offset = 0;
+	while (Worker.bAlive)
+	{
+		const uint8* Data = Worker.ReceiveBuffer.data();
+		const size_t Size = Worker.ReceiveBuffer.size();
+		size_t MessageOffset = Offset;
+		uint32 Length = 0;
+		if (!ReadBinary(Data, Size, MessageOffset, Length)) break;
+		if (Length == 0 || Length > MaxMessageSize)
+		{
+			DropWorker(Worker, State);
+			break;
+		}
+		if (MessageOffset + Length > Size) break; // Wait for the rest of the message
+
+		const size_t MessageEnd = MessageOffset + Length;
+		uint8 Type = Data[MessageOffset++];
+		Offset = MessageEnd;
+
+		if (Type == uint8(EMessageType::Hello))
+		{
+			uint32 Version = 0;
+			if (!ReadBinary(Data, MessageEnd, MessageOffset, Version) || Version != ProtocolVersion)
+			{
+				LogMessage(LogLevel::Error, "Distributed: rejected a worker with protocol version " + std::to_string(Version));
+				DropWorker(Worker, State);
+			}
+		}
+		else if (Type == uint8(EMessageType::Results))
+		{
+			uint32 Generation = 0, Count = 0;
+			if (!ReadBinary(Data, MessageEnd, MessageOffset, Generation) || !ReadBinary(Data, MessageEnd, MessageOffset, Count))
+			{
+				DropWorker(Worker, State);
+				break;
+			}
+
+			// A batch is always answered by a single message, so the worker is idle again whatever generation the results belong to
+			bool bCurrent = State && Generation == State->Generation && Worker.InFlightGeneration == State->Generation;
+			for (uint32 Idx = 0; Idx != Count; ++Idx)
+			{
+				uint32 TaskIdx = 0;
+				double Fitness = 0.0;
+				if (!ReadBinary(Data, MessageEnd, MessageOffset, TaskIdx) || !ReadBinary(Data, MessageEnd, MessageOffset, Fitness)) break;
+				if (!bCurrent || TaskIdx >= State->bDone.size()) continue;
+
+				State->InFlightCopies[TaskIdx]--;
+				if (State->bDone[TaskIdx]) continue; // A straggler copy already reported, the first result wins
+				(*State->Genomes)[TaskIdx]->Fitness = Fitness;
+				State->bDone[TaskIdx] = 1;
+				State->NumDone++;
+			}
+			Worker.InFlight.Reset();
+		}
+	}
+
+	if (Offset > 0 && Worker.bAlive) Worker.ReceiveBuffer.erase(Worker.ReceiveBuffer.begin(), Worker.ReceiveBuffer.begin() + Offset);
+}
+
+void Coordinator::PollWorkers(int TimeoutMs, EvaluationState* State)
+{
+	std::vector<PollDescriptor> Descriptors;
+	TArray<WorkerConnectionPtr> Polled;
+	if (bListening) Descriptors.push_back(PollDescriptor{ decltype(PollDescriptor::fd)(ListenSocket), POLLIN, 0 });
+	for (const auto& Worker : Workers)
+	{
+		if (!Worker->bAlive) continue;
+		Descriptors.push_back(PollDescriptor{ decltype(PollDescriptor::fd)(Worker->Socket), POLLIN, 0 });
+		Polled.Add(Worker);
+	}
+
+	if (PollSockets(Descriptors.data(), Descriptors.size(), TimeoutMs) <= 0) return;
+
+	size_t DescriptorIdx = 0;
+	if (bListening && (Descriptors[DescriptorIdx++].revents & POLLIN)) AcceptWorkers();
+
+	uint8 Buffer[65536];
+	for (auto& Worker : Polled)
+	{
+		const auto Events = Descriptors[DescriptorIdx++].revents;
+		if (!(Events & (POLLIN | POLLERR | POLLHUP))) continue;
+
+		auto Received = recv(Worker->Socket, reinterpret_cast<char*>(Buffer), int(sizeof(Buffer)), 0);
+		if (Received <= 0)
+		{
+			DropWorker(*Worker, State);
+			continue;
+		}
+		Worker->ReceiveBuffer.insert(Worker->ReceiveBuffer.end(), Buffer, Buffer + Received);
+		ProcessMessages(*Worker, State);
+	}
+
+	Workers.RemoveByPredicate([](const WorkerConnectionPtr& Worker) { return !Worker->bAlive; });
+}
+
+bool Coordinator::Evaluate(const TArray<GenomePtr>& Genomes, unsigned Generation, TArray<int>& OutUnfinished)
+{
+	const int NumTasks = Genomes.Num();
+	OutUnfinished.Reset();
+
+	EvaluationState State;
+	State.Genomes = &Genomes;
+	State.Generation = Generation;
+	State.Payloads.resize(NumTasks);
+	State.bDone.assign(NumTasks, 0);
+	State.InFlightCopies.assign(NumTasks, 0);
+	State.DispatchTimes.assign(NumTasks, Clock::now());
+	for (int TaskIdx = 0; TaskIdx != NumTasks; ++TaskIdx)
+	{
+		Genomes[TaskIdx]->Genotype.SerializeBinary(State.Payloads[TaskIdx]);
+		State.Pending.push_back(TaskIdx);
+	}
+
+	auto WaitStart = Clock::now();
+	while (bListening && State.NumDone < NumTasks)
+	{
+		if (GetNumWorkers() == 0)
+		{
+			if (SecondsSince(WaitStart) >= Config->DistributedWorkerWait) break; // No worker to evaluate on, the caller finishes the rest locally
+		}
+		else
+		{
+			WaitStart = Clock::now();
+		}
+
+		for (int Idx = 0; Idx < Workers.Num(); ++Idx)
+		{
+			auto Worker = Workers[Idx];
+			if (Worker->bAlive && Worker->InFlight.IsEmpty()) DispatchBatch(*Worker, State);
+		}
+
+		PollWorkers(10, &State);
+	}
+
+	for (int TaskIdx = 0; TaskIdx != NumTasks; ++TaskIdx)
+	{
+		if (!State.bDone[TaskIdx]) OutUnfinished.Add(TaskIdx);
+	}
+	return OutUnfinished.IsEmpty();
+}
+
+void Coordinator::Shutdown()
+{
+	for (auto& Worker : Workers)
+	{
+		if (!Worker->bAlive) continue;
+		SendPacket(Worker->Socket, EMessageType::Shutdown, {});
+		CloseSocket(Worker->Socket);
+		Worker->bAlive = false;
+	}
+	Workers.Reset();
+
+	if (bListening)
+	{
+		CloseSocket(ListenSocket);
+		ListenSocket = InvalidSocket;
+		bListening = false;
+	}
+}
+
+int RunWorker(Trainer& InTrainer, const std::string& Host, int Port)
+{
+	const ConfigPtr& Config = InTrainer.Config;
+	if (!InitializeSockets()) return 1;
+
+	addrinfo Hints = {};
+	Hints.ai_family = AF_UNSPEC;
+	Hints.ai_socktype = SOCK_STREAM;
+	addrinfo* Addresses = nullptr;
+	if (getaddrinfo(Host.c_str(), std::to_string(Port).c_str(), &Hints, &Addresses) != 0)
+	{
+		LogMessage(LogLevel::Error, "Distributed: could not resolve " + Host);
+		return 1;
+	}
+
+	// The coordinator may still be starting up, so keep retrying for a while before giving up
+	SocketHandle Socket = InvalidSocket;
+	for (int Attempt = 0; Attempt != 30 && Socket == InvalidSocket; ++Attempt)
+	{
+		for (addrinfo* Address = Addresses; Address && Socket == InvalidSocket; Address = Address->ai_next)
+		{
+			Socket = SocketHandle(socket(Address->ai_family, Address->ai_socktype, Address->ai_protocol));
+			if (Socket == InvalidSocket) continue;
+			if (connect(Socket, Address->ai_addr, int(Address->ai_addrlen)) == 0) break;
+			CloseSocket(Socket);
+			Socket = InvalidSocket;
+		}
+		if (Socket == InvalidSocket) std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+	freeaddrinfo(Addresses);
+
+	if (Socket == InvalidSocket)
+	{
+		LogMessage(LogLevel::Error, "Distributed: could not connect to " + Host + ":" + std::to_string(Port));
+		return 1;
+	}
+
+	SetNoDelay(Socket);
+	InitializeRandomSeed(Config->RandomSeed);
+
+	std::vector<uint8> Hello;
+	WriteBinary(Hello, ProtocolVersion);
+	SendPacket(Socket, EMessageType::Hello, Hello);
+	LogMessage(LogLevel::Info, "Distributed: worker connected to " + Host + ":" + std::to_string(Port));
+
+	std::vector<uint8> Message;
+	while (true)
+	{
+		uint32 Length = 0;
+		if (!ReceiveAll(Socket, reinterpret_cast<uint8*>(&Length), sizeof(Length)) || Length == 0 || Length > MaxMessageSize) break;
+		Message.resize(Length);
+		if (!ReceiveAll(Socket, Message.data(), Length)) break;
+
+		const uint8* Data = Message.data();
+		size_t Offset = 1;
+		if (Data[0] == uint8(EMessageType::Shutdown)) break;
+		if (Data[0] != uint8(EMessageType::EvaluateBatch)) continue;
+
+		uint32 Generation = 0, Count = 0;
+		if (!ReadBinary(Data, Length, Offset, Generation) || !ReadBinary(Data, Length, Offset, Count)) break;
+
+		TArray<uint32> TaskIndices;
+		TArray<GenomePtr> Genomes;
+		bool bValid = true;
+		for (uint32 Idx = 0; Idx != Count && bValid; ++Idx)
+		{
+			uint32 TaskIdx = 0;
+			auto Genome = MakeArenaShared<NEAT::Genome>(Config);
+			bValid = ReadBinary(Data, Length, Offset, TaskIdx) && ReadBinary(Data, Length, Offset, Genome->ID) && ReadBinary(Data, Length, Offset, Genome->SpeciesID)
+				&& Genome->Genotype.DeserializeBinary(Data, Length, Offset);
+			TaskIndices.Add(TaskIdx);
+			Genomes.Add(Genome);
+		}
+		if (!bValid)
+		{
+			LogMessage(LogLevel::Error, "Distributed: received a malformed batch");
+			break;
+		}
+
+		// Each task draws from the same random stream it would use when evaluated locally, so results don't depend on where a genome ran
+		auto EvaluateRange = [&](int StartIdx, int EndIdx)
+		{
+			for (int Idx = StartIdx; Idx < EndIdx; ++Idx)
+			{
+				Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, TaskIndices[Idx]));
+				Genomes[Idx]->Fitness = InTrainer.Evaluate(Genomes[Idx]);
+			}
+		};
+
+		int NumThreads = Config->MultithreadedEvaluation ? Math::Min(Config->GetNumThreads(), Genomes.Num()) : 1;
+		if (NumThreads > 1)
+		{
+			std::vector<std::thread> Threads;
+			for (int ThreadIdx = 0; ThreadIdx != NumThreads; ++ThreadIdx)
+			{
+				Threads.emplace_back(EvaluateRange, ThreadIdx * Genomes.Num() / NumThreads, (ThreadIdx + 1) * Genomes.Num() / NumThreads);
+			}
+			for (auto& Thread : Threads) Thread.join();
+		}
+		else
+		{
+			EvaluateRange(0, Genomes.Num());
+		}
+
+		std::vector<uint8> Results;
+		WriteBinary(Results, Generation);
+		WriteBinary(Results, uint32(Genomes.Num()));
+		for (int Idx = 0; Idx != Genomes.Num(); ++Idx)
+		{
+			WriteBinary(Results, TaskIndices[Idx]);
+			WriteBinary(Results, Genomes[Idx]->Fitness);
+		}
+		if (!SendPacket(Socket, EMessageType::Results, Results)) break;
+	}
+
+	CloseSocket(Socket);
+	LogMessage(LogLevel::Info, "Distributed: worker disconnected from " + Host + ":" + std::to_string(Port));
+	return 0;
+}
+
+} // namespace Distributed
+} // namespace NEAT
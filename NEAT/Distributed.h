@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "Array.h"
+
+// Distributed evaluation over TCP.
+// The training process acts as the coordinator: it listens for worker processes, ships batches of genotypes to them in the compact binary encoding, and collects the fitness values back.
+// Work held by a worker that disconnects is requeued. Once the queue runs dry, idle workers re-run tasks that have been outstanding longer than the straggler timeout, and the first result received for a task wins.
+// Workers are ordinary processes built with the same Trainer subclass, started with Trainer::RunWorker, so the whole setup can be tested on one host over loopback.
+
+namespace NEAT
+{
+	class Config;
+	//using ConfigPtr = std::shared_ptr<const NEAT::Config>;
+	using ConfigPtr = std::shared_ptr<NEAT::Config>;
+
+	class Genome;
+	using GenomePtr = std::shared_ptr<NEAT::Genome>;
+
+	class Trainer;
+
+	namespace Distributed
+	{
+#ifdef _WIN32
+		using SocketHandle = unsigned long long; // SOCKET
+#else
+		using SocketHandle = int;
+#endif
+
+		enum class EMessageType : uint8
+		{
+			Hello, // Worker -> Coordinator: protocol version
+			EvaluateBatch, // Coordinator -> Worker: generation, then the index and genotype of each task
+			Results, // Worker -> Coordinator: generation, then the index and fitness of each task
+			Shutdown, // Coordinator -> Worker: no more work will be sent
+		};
+
+		class Coordinator
+		{
+		public:
+			Coordinator(const ConfigPtr& InConfig);
+			~Coordinator();
+
+			bool Listen(int Port); // Starts accepting worker connections on the given port, returns false if the socket could not be bound
+			bool Evaluate(const TArray<GenomePtr>& Genomes, unsigned Generation, TArray<int>& OutUnfinished); // Evaluates the genomes on the connected workers, returns false and fills OutUnfinished with the indices, in ascending order, of the genomes the caller has to evaluate locally when no worker was available
+			void Shutdown(); // Tells every worker to exit and closes all connections
+
+			int GetNumWorkers() const;
+
+		private:
+			struct WorkerConnection
+			{
+				SocketHandle Socket = 0;
+				std::vector<uint8> ReceiveBuffer;
+				TArray<int> InFlight; // Task indices of the batch the worker is currently evaluating
+				unsigned InFlightGeneration = 0;
+				bool bAlive = true;
+			};
+			using WorkerConnectionPtr = std::shared_ptr<WorkerConnection>;
+
+			struct EvaluationState; // Per-call bookkeeping of Evaluate, defined in Distributed.cpp
+
+			void AcceptWorkers();
+			void PollWorkers(int TimeoutMs, EvaluationState* State);
+			void ProcessMessages(WorkerConnection& Worker, EvaluationState* State);
+			void DropWorker(WorkerConnection& Worker, EvaluationState* State);
+			bool DispatchBatch(WorkerConnection& Worker, EvaluationState& State);
+
+			ConfigPtr Config = nullptr;
+			SocketHandle ListenSocket = 0;
+			bool bListening = false;
+			TArray<WorkerConnectionPtr> Workers;
+		};
+
+		int RunWorker(Trainer& InTrainer, const std::string& Host, int Port); // Connects to a coordinator and evaluates the batches it sends until it shuts down, returns non-zero if no connection could be made
+	}
+} // namespace NEAT
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <coroutine>
+#include <utility>
+#include "Types.h"
+#include "Array.h"
+
+// Coroutine evaluation for control and simulation tasks, where Evaluate is a long "query the network, step the environment" loop.
+// A Trainer that overrides EvaluateAsync writes that loop as a coroutine: "TArray<double> Action = co_yield Observation;" suspends the evaluation until the trainer
+// queried the genome's network with the observation, and "co_return Fitness;" ends it.
+// With Config->AsyncEvaluation the trainer keeps many evaluations in flight and answers all of their pending queries together, once per step.
+
+namespace NEAT
+{
+	class EvaluationTask
+	{
+	public:
+		struct promise_type
+		{
+			TArray<double> Observation; // The inputs of the pending network query
+			TArray<double> Action; // The network outputs the evaluation is resumed with
+			double Fitness = 0.0;
+
+			// Hands the network outputs back to the coroutine as the result of co_yield
+			struct QueryAwaiter
+			{
+				promise_type& Promise;
+
+				bool await_ready() const noexcept { return false; }
+				void await_suspend(std::coroutine_handle<>) const noexcept { }
+				TArray<double> await_resume() const { return std::move(Promise.Action); }
+			};
+
+			EvaluationTask get_return_object() { return EvaluationTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() const noexcept { return {}; } // Nothing runs until the scheduler first resumes the task, with the genome's random stream bound
+			std::suspend_always final_suspend() const noexcept { return {}; }
+			QueryAwaiter yield_value(TArray<double> InObservation) { Observation = std::move(InObservation); return QueryAwaiter{ *this }; }
+			void return_value(double InFitness) { Fitness = InFitness; }
+			void unhandled_exception() { throw; } // Propagates out of Resume, like an exception thrown by Evaluate
+		};
+		using Handle = std::coroutine_handle<promise_type>;
+
+		EvaluationTask() = default;
+		EvaluationTask(EvaluationTask&& Other) noexcept : Coroutine(std::exchange(Other.Coroutine, nullptr)) { }
+		EvaluationTask& operator=(EvaluationTask&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				if (Coroutine) Coroutine.destroy();
+				Coroutine = std::exchange(Other.Coroutine, nullptr);
+			}
+			return *this;
+		}
+		~EvaluationTask() { if (Coroutine) Coroutine.destroy(); }
+
+		EvaluationTask(const EvaluationTask&) = delete;
+		EvaluationTask& operator=(const EvaluationTask&) = delete;
+
+		// Runs the evaluation until its next network query or its end, returns true while a query is pending
+		bool Resume()
+		{
+			if (IsDone()) return false;
+			Coroutine.resume();
+			return !Coroutine.done();
+		}
+
+		bool IsDone() const { return !Coroutine || Coroutine.done(); }
+		const TArray<double>& GetObservation() const { return Coroutine.promise().Observation; } // Only valid while a query is pending
+		void SetAction(TArray<double> Action) { Coroutine.promise().Action = std::move(Action); } // Answers the pending query, before the next Resume
+		double GetFitness() const { return Coroutine ? Coroutine.promise().Fitness : 0.0; } // Only valid once the evaluation is done
+
+	private:
+		explicit EvaluationTask(Handle InCoroutine) : Coroutine(InCoroutine) { }
+
+		Handle Coroutine = nullptr;
+	};
+} // namespace NEAT
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "Types.h"
+#include "Genes.h"
+
+// The evolution state that IDs are handed out from: the innovation tracker and the genome and species counters.
+// Each Trainer owns a context and binds it to the threads working for it, so that any number of trainers can evolve concurrently in one process
+// without sharing innovation numbers or IDs. Threads that haven't bound a context use a default one.
+
+namespace NEAT
+{
+	struct EvolutionContext
+	{
+		InnovationTracker Innovations;
+		std::atomic<uint64> NextGenomeID = 0;
+		std::atomic<uint64> NextSpeciesID = 0;
+
+		uint64 ReserveGenomeIDs(uint64 Count) { return NextGenomeID.fetch_add(Count) + 1; } // Returns the first of Count consecutive genome IDs
+		uint64 GenerateSpeciesID() { return NextSpeciesID.fetch_add(1) + 1; }
+	};
+
+	using EvolutionContextPtr = std::shared_ptr<EvolutionContext>;
+
+	inline EvolutionContext*& GetBoundContext() // The context bound to the calling thread, or nullptr
+	{
+		static thread_local EvolutionContext* BoundContext = nullptr;
+		return BoundContext;
+	}
+
+	inline EvolutionContext& GetContext() // Returns the context bound to the calling thread, or the default context
+	{
+		static EvolutionContext DefaultContext;
+		EvolutionContext* BoundContext = GetBoundContext();
+		return BoundContext ? *BoundContext : DefaultContext;
+	}
+
+	// Binds a context to the calling thread for the lifetime of the scope, then restores the previous context. A null context keeps the current one
+	class ScopedContext
+	{
+	public:
+		explicit ScopedContext(EvolutionContext* Context) : PreviousContext(GetBoundContext()) { if (Context) GetBoundContext() = Context; }
+		~ScopedContext() { GetBoundContext() = PreviousContext; }
+
+		ScopedContext(const ScopedContext&) = delete;
+		ScopedContext& operator=(const ScopedContext&) = delete;
+
+	private:
+		EvolutionContext* PreviousContext = nullptr;
+	};
+} // namespace NEAT
@@ -1,3 +1,4 @@
+#include <cmath>
 #include "NEAT.h"
 
 // Create a new NEAT trainer that produces a genome that performs XOR, running for 1000 generations or until a solution is found
@@ -153,20 +154,28 @@ class DotProductTrainer : public NEAT::Trainer
 		}
 	};
 
-	double Evaluate(const NEAT::GenomePtr& Genome) override final
+	static constexpr int NumSamples = 4;
+
+	// Draws a fresh set of random vector pairs and their dot products
+	static void CreateSamples(TArray<InputPair>& Samples, TArray<double>& ExpectedOutputs)
 	{
-		// Create a neural network from the genome  
-		NEAT::NeuralNetworkPtr Network = Genome->CreateNeuralNetwork();
-		TArray<InputPair> Inputs;
-		TArray<double> ExpectedOutputs;
-		for (int Idx = 0; Idx != GetNumInputs(); ++Idx)
+		for (int Idx = 0; Idx != NumSamples; ++Idx)
 		{
 			TArray<double> Vector1 = { NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0) };
 			TArray<double> Vector2 = { NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0) };
 			InputPair Pair = { Vector1, Vector2 };
 			ExpectedOutputs.Add(Pair.GetExpectedOutput());
-			Inputs.Add(std::move(Pair));
+			Samples.Add(std::move(Pair));
 		}
+	}
+
+	double Evaluate(const NEAT::GenomePtr& Genome) override final
+	{
+		// Create a neural network from the genome  
+		NEAT::NeuralNetworkPtr Network = Genome->CreateNeuralNetwork();
+		TArray<InputPair> Inputs;
+		TArray<double> ExpectedOutputs;
+		CreateSamples(Inputs, ExpectedOutputs);
 
 		TArray<double> Outputs;
 		for (int i = 0; i < Inputs.Num(); i++)
@@ -178,9 +187,39 @@ class DotProductTrainer : public NEAT::Trainer
 		return NEAT::Fitness::Regression::MeanAbsoluteError(Outputs, ExpectedOutputs);
 	}
 
+	// Scores the whole batch on one set of samples, sample-major, so that each sample is flattened once and stays in cache while every network evaluates it
+	void EvaluateBatch(std::span<const NEAT::GenomePtr> Genomes) override final
+	{
+		TArray<InputPair> Inputs;
+		TArray<double> ExpectedOutputs;
+		CreateSamples(Inputs, ExpectedOutputs);
+
+		TArray<NEAT::NeuralNetworkPtr> Networks;
+		TArray<TArray<double>> Outputs;
+		for (const auto& Genome : Genomes)
+		{
+			Networks.Add(Genome->CreateNeuralNetwork());
+			Outputs.AddGetRef().Reserve(NumSamples);
+		}
+
+		for (auto& Input : Inputs)
+		{
+			const TArray<double> FlattenedInputs = Input.GetFlattenedInputs();
+			for (int Idx = 0, StopIdx = Networks.Num(); Idx != StopIdx; ++Idx)
+			{
+				Outputs[Idx].Add(Networks[Idx]->Evaluate(FlattenedInputs)[0]);
+			}
+		}
+
+		for (int Idx = 0, StopIdx = Networks.Num(); Idx != StopIdx; ++Idx)
+		{
+			Genomes[Idx]->Fitness = NEAT::Fitness::Regression::MeanAbsoluteError(Outputs[Idx], ExpectedOutputs);
+		}
+	}
+
 public:
 	DotProductTrainer(const NEAT::ConfigPtr& Config) : NEAT::Trainer(Config) { }
-	int GetNumInputs() const override { return 4; } // Returns the number of inputs for the neural network
+	int GetNumInputs() const override { return 6; } // Returns the number of inputs for the neural network, the two flattened 3D vectors
 	int GetNumOutputs() const override { return 1; } // Returns the number of outputs for the neural network
 
 	void Report()
@@ -191,7 +230,7 @@ public:
 
 			NEAT::NeuralNetworkPtr Network = BestGenome.CreateNeuralNetwork();
 			NEAT::LogMessage(NEAT::LogLevel::Info, "Testing solution with inputs:");
-			for (int Idx = 0; Idx < GetNumInputs(); ++Idx)
+			for (int Idx = 0; Idx < NumSamples; ++Idx)
 			{
 				TArray<double> Vector1 = { NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0) };
 				TArray<double> Vector2 = { NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0), NEAT::GetRandomDouble(-1.0, 1.0) };
@@ -205,4 +244,75 @@ public:
 			NEAT::LogMessage(NEAT::LogLevel::Info, "No solution found after 1000 generations.");
 		}
 	}
+};
+
+// Balances a pole on a cart for up to 1000 steps. The episode loop is written as a coroutine, so that many episodes can be stepped together with Config->AsyncEvaluation
+class CartPoleTrainer : public NEAT::Trainer
+{
+	static constexpr int MaxSteps = 1000;
+
+	NEAT::EvaluationTask EvaluateAsync(const NEAT::GenomePtr&) override final // The network is queried through co_yield, the genome itself isn't needed
+	{
+		constexpr double Gravity = 9.8;
+		constexpr double CartMass = 1.0;
+		constexpr double PoleMass = 0.1;
+		constexpr double PoleHalfLength = 0.5;
+		constexpr double ForceMagnitude = 10.0;
+		constexpr double TimeStep = 0.02;
+		constexpr double PositionLimit = 2.4;
+		constexpr double AngleLimit = 0.2094; // 12 degrees
+
+		double Position = NEAT::GetRandomDouble(-0.05, 0.05);
+		double Velocity = NEAT::GetRandomDouble(-0.05, 0.05);
+		double Angle = NEAT::GetRandomDouble(-0.05, 0.05);
+		double AngularVelocity = NEAT::GetRandomDouble(-0.05, 0.05);
+
+		int Step = 0;
+		for (; Step != MaxSteps; ++Step)
+		{
+			// Suspends until the trainer queried the network with the observation
+			TArray<double> Observation;
+			Observation.Append({ Position / PositionLimit, Velocity, Angle / AngleLimit, AngularVelocity });
+			TArray<double> Action = co_yield std::move(Observation);
+			const double Force = Action[0] > 0.5 ? ForceMagnitude : -ForceMagnitude;
+
+			const double CosAngle = std::cos(Angle);
+			const double SinAngle = std::sin(Angle);
+			const double Temp = (Force + PoleMass * PoleHalfLength * AngularVelocity * AngularVelocity * SinAngle) / (CartMass + PoleMass);
+			const double AngularAcceleration = (Gravity * SinAngle - CosAngle * Temp) / (PoleHalfLength * (4.0 / 3.0 - PoleMass * CosAngle * CosAngle / (CartMass + PoleMass)));
+			const double Acceleration = Temp - PoleMass * PoleHalfLength * AngularAcceleration * CosAngle / (CartMass + PoleMass);
+
+			Position += TimeStep * Velocity;
+			Velocity += TimeStep * Acceleration;
+			Angle += TimeStep * AngularVelocity;
+			AngularVelocity += TimeStep * AngularAcceleration;
+
+			if (std::abs(Position) > PositionLimit || std::abs(Angle) > AngleLimit) break;
+		}
+
+		co_return double(Step) / MaxSteps;
+	}
+
+	double Evaluate(const NEAT::GenomePtr& Genome) override final
+	{
+		return EvaluateSynchronously(Genome);
+	}
+
+public:
+	CartPoleTrainer(const NEAT::ConfigPtr& Config) : NEAT::Trainer(Config) { }
+
+	int GetNumInputs() const override { return 4; } // Returns the number of inputs for the neural network
+	int GetNumOutputs() const override { return 1; } // Returns the number of outputs for the neural network
+
+	void Report()
+	{
+		if (bHasBestGenome)
+		{
+			NEAT::LogMessage(NEAT::LogLevel::Info, "Best genome balanced the pole for " + std::to_string(int(BestGenome.Fitness * MaxSteps)) + " of " + std::to_string(MaxSteps) + " steps.");
+		}
+		else
+		{
+			NEAT::LogMessage(NEAT::LogLevel::Info, "No solution found after 1000 generations.");
+		}
+	}
 };
\ No newline at end of file
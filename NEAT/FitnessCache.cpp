@@ -0,0 +1,60 @@
+#include "FitnessCache.h"
+
+namespace NEAT
+{
+	FitnessCache::FitnessCache(int InCapacity)
+		: Capacity(InCapacity > 0 ? InCapacity : 1)
+	{
+	}
+
+	bool FitnessCache::Find(uint64 Hash, double& OutFitness)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Entry* Found = Entries.Find(Hash);
+			if (Found)
+			{
+				Found->LastUsedGeneration = CurrentGeneration;
+				OutFitness = Found->Fitness;
+				return true;
+			}
+		}
+
+		if (!PersistentStore || !PersistentStore->Find(Hash, OutFitness)) return false;
+
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Entries[Hash] = Entry{ OutFitness, CurrentGeneration }; // Later lookups this run skip the store
+		return true;
+	}
+
+	void FitnessCache::Store(uint64 Hash, double Fitness)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Entries[Hash] = Entry{ Fitness, CurrentGeneration };
+		}
+		if (PersistentStore) PersistentStore->Store(Hash, Fitness);
+	}
+
+	void FitnessCache::SetStore(const FitnessStorePtr& InStore)
+	{
+		PersistentStore = InStore;
+	}
+
+	void FitnessCache::Trim(unsigned Generation)
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (Entries.Num() > Capacity)
+		{
+			const unsigned LastGeneration = CurrentGeneration;
+			Entries.RemoveByPredicate([LastGeneration](const auto& EntryPair) { return EntryPair.second.LastUsedGeneration != LastGeneration; });
+		}
+		CurrentGeneration = Generation;
+	}
+
+	int FitnessCache::Num() const
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Entries.Num();
+	}
+} // namespace NEAT
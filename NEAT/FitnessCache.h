@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mutex>
+#include "Types.h"
+#include "Map.h"
+#include "FitnessStore.h"
+
+// Memoized fitness values keyed by Genotype::GetFullHash, so that elites and unmutated clones aren't evaluated again.
+// Only valid for deterministic fitness functions, a cached genome keeps the fitness it was first given.
+// With a FitnessStore attached, fitness values are also kept on disk and genomes scored in earlier runs are found there.
+
+namespace NEAT
+{
+	class FitnessCache
+	{
+	public:
+		FitnessCache(int InCapacity);
+
+		bool Find(uint64 Hash, double& OutFitness); // Returns true and the cached fitness if the genotype was scored before, and marks the entry as used this generation
+		void Store(uint64 Hash, double Fitness); // Caches the fitness of a genotype, thread-safe
+		void Trim(unsigned Generation); // Starts a new generation, dropping the entries that weren't used in the last generation once the cache is over capacity
+		void SetStore(const FitnessStorePtr& InStore); // Looks up the genotypes missing from the cache in InStore, and stores every cached fitness in it
+
+		int Num() const;
+
+	private:
+		struct Entry
+		{
+			double Fitness = 0.0;
+			unsigned LastUsedGeneration = 0;
+		};
+
+		mutable std::mutex Mutex;
+		TMap<uint64, Entry> Entries;
+		int Capacity = 0;
+		unsigned CurrentGeneration = 0;
+		FitnessStorePtr PersistentStore = nullptr; // Thread-safe on its own, so it's used outside of Mutex
+	};
+} // namespace NEAT
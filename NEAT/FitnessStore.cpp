@@ -0,0 +1,218 @@
+#include "FitnessStore.h"
+#include "Utils.h"
+#include <chrono>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NEAT
+{
+	namespace
+	{
+		constexpr uint64 FileMagic = 0x4E45415446495431ull; // Written last when the file is created, the file is usable once it is set
+		constexpr uint64 EntryEmpty = 0;
+		constexpr uint64 EntryWriting = 1; // Claimed, the key and fitness are being written
+		constexpr uint64 EntryPublished = 2;
+		constexpr uint64 HashScheme = 2; // Mixed into the version tag, and bumped whenever Genotype's hashes change so that entries keyed by older hashes stop matching
+		constexpr int MaxWaitRounds = 100000; // Rounds a run waits for another to finish creating the file
+
+		void Backoff(int Rounds)
+		{
+			if (Rounds < 64) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+		uint64 HashVersion(const std::string& Version) // FNV-1a, stable across processes and builds unlike std::hash
+		{
+			uint64 Hash = 0xCBF29CE484222325ull;
+			for (char Character : Version)
+			{
+				Hash ^= uint8(Character);
+				Hash *= 0x100000001B3ull;
+			}
+			return Hash;
+		}
+	}
+
+	struct FitnessStore::FileHeader
+	{
+		std::atomic<uint64> Magic;
+		uint64 Capacity;
+	};
+
+	struct FitnessStore::Entry
+	{
+		std::atomic<uint64> State;
+		uint64 Hash;
+		uint64 VersionTag;
+		double Fitness;
+	};
+
+	FitnessStore::FitnessStore(const std::string& InFilename, const std::string& Version, int InCapacity)
+		: Filename(InFilename)
+		, VersionTag(HashVersion(Version) ^ HashScheme)
+		, Capacity(uint64(InCapacity > 0 ? InCapacity : 1 << 20))
+	{
+	}
+
+	FitnessStore::~FitnessStore()
+	{
+		Close();
+	}
+
+	bool FitnessStore::IsSupported()
+	{
+#ifdef _WIN32
+		return false;
+#else
+		return true;
+#endif
+	}
+
+	FitnessStore::Entry* FitnessStore::GetEntry(uint64 EntryIdx) const
+	{
+		return reinterpret_cast<Entry*>(Mapping + 64 + EntryIdx * sizeof(Entry)); // The file header occupies the first cache line
+	}
+
+	FitnessStore::Entry* FitnessStore::Probe(uint64 Hash, bool bClaim, bool& bOutClaimed) const
+	{
+		bOutClaimed = false;
+		const uint64 Start = (Hash ^ VersionTag) * 0x9E3779B97F4A7C15ull;
+		for (uint64 ProbeIdx = 0; ProbeIdx != Capacity; ++ProbeIdx) // Linear probing, entries are never removed so a lookup can stop at the first empty entry
+		{
+			Entry* Current = GetEntry((Start + ProbeIdx) % Capacity);
+			uint64 State = Current->State.load(std::memory_order_acquire);
+			if (State == EntryEmpty)
+			{
+				if (!bClaim) return nullptr;
+				if (Current->State.compare_exchange_strong(State, EntryWriting, std::memory_order_acq_rel))
+				{
+					bOutClaimed = true;
+					return Current;
+				}
+				// Another thread claimed it first, State now holds what it wrote
+			}
+
+			// Entries still being written are passed over rather than waited on. Two threads storing the same genotype at once may both add it, the first entry is then the one found
+			if (State == EntryPublished && Current->Hash == Hash && Current->VersionTag == VersionTag) return Current;
+		}
+
+		return nullptr;
+	}
+
+	bool FitnessStore::Find(uint64 Hash, double& OutFitness) const
+	{
+		if (!Mapping) return false;
+
+		bool bClaimed = false;
+		const Entry* Found = Probe(Hash, false, bClaimed);
+		if (!Found) return false;
+
+		OutFitness = Found->Fitness;
+		return true;
+	}
+
+	bool FitnessStore::Store(uint64 Hash, double Fitness)
+	{
+		if (!Mapping) return false;
+
+		bool bClaimed = false;
+		Entry* Found = Probe(Hash, true, bClaimed);
+		if (!Found)
+		{
+			if (!bReportedFull.exchange(true)) LogMessage(LogLevel::Warning, "Fitness store " + Filename + " is full, new fitness values are no longer stored");
+			return false;
+		}
+		if (!bClaimed) return true; // Stored before, the first fitness is kept
+
+		Found->Hash = Hash;
+		Found->VersionTag = VersionTag;
+		Found->Fitness = Fitness;
+		Found->State.store(EntryPublished, std::memory_order_release);
+		return true;
+	}
+
+#ifndef _WIN32
+	bool FitnessStore::Open()
+	{
+		if (Mapping) return true;
+
+		bool bCreated = true;
+		int File = open(Filename.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (File < 0)
+		{
+			bCreated = false;
+			File = open(Filename.c_str(), O_RDWR);
+		}
+		if (File < 0)
+		{
+			LogMessage(LogLevel::Error, "Failed to open fitness store " + Filename);
+			return false;
+		}
+
+		if (bCreated)
+		{
+			MappingSize = 64 + Capacity * sizeof(Entry);
+			if (ftruncate(File, off_t(MappingSize)) != 0)
+			{
+				LogMessage(LogLevel::Error, "Failed to size fitness store " + Filename);
+				close(File);
+				unlink(Filename.c_str());
+				return false;
+			}
+		}
+		else // The run that created the file sized it, which also decided its capacity
+		{
+			struct stat Status = {};
+			for (int Rounds = 0; fstat(File, &Status) == 0 && Status.st_size == 0 && Rounds != MaxWaitRounds; ++Rounds) Backoff(Rounds);
+			MappingSize = size_t(Status.st_size);
+		}
+
+		void* Memory = MappingSize > 64 ? mmap(nullptr, MappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0) : MAP_FAILED;
+		close(File);
+		if (Memory == MAP_FAILED)
+		{
+			LogMessage(LogLevel::Error, "Failed to map fitness store " + Filename);
+			return false;
+		}
+
+		Mapping = static_cast<uint8*>(Memory);
+		auto* Header = reinterpret_cast<FileHeader*>(Mapping);
+		if (bCreated) // ftruncate zero-fills the file, so every entry starts out empty
+		{
+			new (Header) FileHeader{ { 0 }, Capacity };
+			Header->Magic.store(FileMagic, std::memory_order_release);
+		}
+		else
+		{
+			for (int Rounds = 0; Header->Magic.load(std::memory_order_acquire) != FileMagic && Rounds != MaxWaitRounds; ++Rounds) Backoff(Rounds);
+			if (Header->Magic.load(std::memory_order_acquire) != FileMagic || 64 + Header->Capacity * sizeof(Entry) > MappingSize)
+			{
+				LogMessage(LogLevel::Error, Filename + " is not a fitness store");
+				Close();
+				return false;
+			}
+			Capacity = Header->Capacity;
+		}
+
+		LogMessage(LogLevel::Info, std::string(bCreated ? "Created" : "Opened") + " fitness store " + Filename + " with room for " + std::to_string(Capacity) + " fitness values");
+		return true;
+	}
+
+	void FitnessStore::Close()
+	{
+		if (!Mapping) return;
+		munmap(Mapping, MappingSize);
+		Mapping = nullptr;
+	}
+#else
+	bool FitnessStore::Open() { return false; }
+	void FitnessStore::Close() { }
+#endif
+} // namespace NEAT
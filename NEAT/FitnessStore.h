@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "Types.h"
+
+// Fitness values kept on disk across runs, for trainers that are run many times over the same data, such as Config sweeps.
+// The file is a memory-mapped, append-only hash table keyed by Genotype::GetFullHash and a version tag naming the dataset and the fitness function.
+// Entries are claimed with compare-and-swap and never changed once published, so every thread, and every process mapping the same file, looks up and adds entries without locks.
+// An entry left half-written by a run that crashed is skipped over.
+// A fitness is only reused under the version tag it was stored with, so change the tag whenever Evaluate or its data changes. Only available on POSIX systems.
+
+namespace NEAT
+{
+	class FitnessStore
+	{
+	public:
+		FitnessStore(const std::string& InFilename, const std::string& Version, int InCapacity);
+		~FitnessStore();
+
+		FitnessStore(const FitnessStore&) = delete;
+		FitnessStore& operator=(const FitnessStore&) = delete;
+
+		static bool IsSupported(); // Returns false on platforms without memory-mapped files
+
+		bool Open(); // Maps the file, creating it with room for Capacity entries if it doesn't exist
+		void Close(); // Unmaps the file, the entries are already on it
+		bool IsOpen() const { return Mapping != nullptr; }
+
+		bool Find(uint64 Hash, double& OutFitness) const; // Returns true and the stored fitness if a genotype with this hash was stored under the version tag
+		bool Store(uint64 Hash, double Fitness); // Stores the fitness of a genotype, keeping the first fitness stored for it. Returns false once the file is full
+
+	private:
+		struct FileHeader;
+		struct Entry;
+
+		Entry* GetEntry(uint64 EntryIdx) const;
+		Entry* Probe(uint64 Hash, bool bClaim, bool& bOutClaimed) const; // Returns the published entry of Hash under the version tag. Otherwise claims an empty entry for it if bClaim is set, or returns nullptr
+
+		std::string Filename;
+		uint64 VersionTag = 0;
+		uint64 Capacity = 0;
+		size_t MappingSize = 0;
+		uint8* Mapping = nullptr;
+		mutable std::atomic<bool> bReportedFull = false;
+	};
+
+	using FitnessStorePtr = std::shared_ptr<FitnessStore>;
+} // namespace NEAT
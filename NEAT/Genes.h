@@ -3,6 +3,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include "Aggregations.h"
 #include "Activations.h"
 #include "Mutations.h"
@@ -10,11 +11,12 @@
 #include "Types.h"
 #include "Array.h"
 #include "Map.h"
+#include "SharedInnovations.h"
 
 namespace NEAT 
 {
 	enum class EGeneType { Node, Connection };
-	enum class ENodeType { Input, Hidden, Output };
+	enum class ENodeType : uint8 { Input, Hidden, Output };
 
 	struct Innovation
 	{
@@ -34,23 +36,46 @@ namespace NEAT
 	{
 		std::atomic<uint64> NextInnovationID;
 		TMap<uint64, Innovation> Innovations;
+		TArray<Innovation> InitialConnections; // Every connection of the initial topology in creation order, numbered once by InitialTopology::RegisterInnovations and read by every initial genome
+		const InnovationTracker* Base = nullptr; // Set by Extend, innovations Base already numbered are reused and new ones get provisional IDs
+		SharedInnovationTablePtr Shared = nullptr; // Set when innovations are numbered together with other processes (see Config->SharedInnovations), Innovations then caches the IDs looked up in it
+
+		static constexpr uint64 FirstProvisionalID = uint64(1) << 63; // Provisional IDs never collide with the IDs of a real tracker
 
 		InnovationTracker() : NextInnovationID(0) {}
-		InnovationTracker(const InnovationTracker& Other) : NextInnovationID(Other.NextInnovationID.load()), Innovations(Other.Innovations) {}
-		InnovationTracker(InnovationTracker&& Other) noexcept : NextInnovationID(Other.NextInnovationID.load()), Innovations(std::move(Other.Innovations)) {}
+		InnovationTracker(const InnovationTracker& Other) : NextInnovationID(Other.NextInnovationID.load()), Innovations(Other.Innovations), InitialConnections(Other.InitialConnections), Base(Other.Base), Shared(Other.Shared) {}
+		InnovationTracker(InnovationTracker&& Other) noexcept : NextInnovationID(Other.NextInnovationID.load()), Innovations(std::move(Other.Innovations)), InitialConnections(std::move(Other.InitialConnections)), Base(Other.Base), Shared(std::move(Other.Shared)) {}
 
-		InnovationTracker& operator=(const InnovationTracker& Other) { NextInnovationID = Other.NextInnovationID.load(); Innovations = Other.Innovations; return *this; }
-		InnovationTracker& operator=(InnovationTracker&& Other) noexcept { NextInnovationID = Other.NextInnovationID.load(); Innovations = std::move(Other.Innovations); return *this; }
+		InnovationTracker& operator=(const InnovationTracker& Other) { NextInnovationID = Other.NextInnovationID.load(); Innovations = Other.Innovations; InitialConnections = Other.InitialConnections; Base = Other.Base; Shared = Other.Shared; return *this; }
+		InnovationTracker& operator=(InnovationTracker&& Other) noexcept { NextInnovationID = Other.NextInnovationID.load(); Innovations = std::move(Other.Innovations); InitialConnections = std::move(Other.InitialConnections); Base = Other.Base; Shared = std::move(Other.Shared); return *this; }
 
 		uint64 GetInnovationID(EMutationType MutationType, EGeneType GeneType, uint64 Input, uint64 Output)
 		{
+			if (Base) // Base is only read, so any number of provisional trackers can extend it from different threads
+			{
+				for (const auto& InnovationPair : Base->Innovations)
+				{
+					const auto& Innovation = InnovationPair.second;
+					if (Innovation.Matches(MutationType, GeneType, Input, Output)) return Innovation.ID;
+				}
+			}
+
 			for (const auto& InnovationPair : Innovations)
 			{
 				const auto& Innovation = InnovationPair.second;
 				if (Innovation.Matches(MutationType, GeneType, Input, Output)) return Innovation.ID;
 			}
 
-			auto NextID = NextInnovationID.fetch_add(1);
+			uint64 NextID = 0;
+			if (Shared && Shared->FindOrAdd(uint32(MutationType), uint32(GeneType), Input, Output, NextID))
+			{
+				if (NextID >= NextInnovationID) NextInnovationID = NextID + 1; // Innovations numbered here once the shared table is full follow the shared ones
+			}
+			else
+			{
+				NextID = NextInnovationID.fetch_add(1);
+			}
+
 			Innovations[NextID] = Innovation{ NextID, MutationType, GeneType, Input, Output };
 			return NextID;
 		}
@@ -59,25 +84,22 @@ namespace NEAT
 		{
 			NextInnovationID = StartingInnovation;
 			Innovations.Reset();
+			InitialConnections.Reset();
+			if (Shared) Shared->RaiseNextID(StartingInnovation);
 		}
-	};
 
-	struct BaseGene
-	{
-		uint64 ID = 0;
-		bool Enabled = true;
-
-		BaseGene(BaseGene&& Other) noexcept : ID(Other.ID), Enabled(Other.Enabled) {}
-		BaseGene(const BaseGene& Other) : ID(Other.ID), Enabled(Other.Enabled) {}
-		BaseGene(uint64 InID, bool InEnabled) : ID(InID), Enabled(InEnabled) {}
-		BaseGene(uint64 InID) : ID(InID), Enabled(true) {}
-		BaseGene() : ID(0), Enabled(true) {}
-		virtual ~BaseGene() {}
-
-		BaseGene& operator=(BaseGene&& Other) noexcept { ID = std::move(Other.ID); Enabled = std::move(Other.Enabled); return *this; }
-		BaseGene& operator=(const BaseGene& Other) { ID = Other.ID; Enabled = Other.Enabled; return *this; }
+		// Makes this a provisional tracker on top of InBase, for mutations that run in parallel. The provisional innovations are numbered for real afterwards,
+		// in a fixed order, by replaying Innovations (ordered by provisional ID, so in the order they were made) on the real tracker
+		void Extend(const InnovationTracker& InBase)
+		{
+			Base = &InBase;
+			Shared = nullptr;
+			NextInnovationID = FirstProvisionalID;
+			Innovations.Reset();
+			InitialConnections.Reset();
+		}
 	};
-	
+
 	namespace NodeType
 	{
 		static std::string ToString(ENodeType NodeType)
@@ -100,46 +122,44 @@ namespace NEAT
 		}
 	}
 
-	struct NodeGene : public BaseGene
-	{
-		EActivation Activation = EActivation::Sigmoid;
-		EAggregation Aggregation = EAggregation::Mean;
-		ENodeType Type = ENodeType::Hidden;
-		double Bias = 0.0;
-
-		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation, double InBias, bool InEnabled) : BaseGene(InID, InEnabled), Type(InType), Activation(InActivation), Aggregation(InAggregation), Bias(InBias) {}
-		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation, double InBias) : BaseGene(InID), Type(InType), Activation(InActivation), Aggregation(InAggregation), Bias(InBias) {}
-		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation) : BaseGene(InID), Type(InType), Activation(InActivation), Aggregation(InAggregation) {}
-		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, double InBias) : BaseGene(InID), Type(InType), Activation(InActivation), Bias(InBias) {}
-		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation) : BaseGene(InID), Type(InType), Activation(InActivation), Bias(0.0) {}
-		NodeGene(NodeGene&& Other) noexcept : BaseGene(std::move(Other.ID), std::move(Other.Enabled)), Type(std::move(Other.Type)), Activation(std::move(Other.Activation)), Bias(std::move(Other.Bias)) {}
-		NodeGene(const NodeGene& Other) : BaseGene(Other.ID, Other.Enabled), Type(Other.Type), Activation(Other.Activation), Bias(Other.Bias) {}
-		NodeGene() = default;
-		virtual ~NodeGene() = default;
-
-		NodeGene& operator=(NodeGene&& Other) noexcept { ID = std::move(Other.ID); Enabled = std::move(Other.Enabled); Type = std::move(Other.Type); Activation = std::move(Other.Activation); Bias = std::move(Other.Bias); return *this; }
-		NodeGene& operator=(const NodeGene& Other) { ID = Other.ID; Enabled = Other.Enabled; Type = Other.Type; Activation = Other.Activation; Bias = Other.Bias; return *this; }
-	};
-
-	using NodeGenePtr = std::shared_ptr<NodeGene>;
-
-	struct ConnectionGene : public BaseGene
-	{
-		explicit ConnectionGene(uint64 InID, uint64 InSourceNode, uint64 InTargetNode, double InWeight, bool InEnabled) : BaseGene(InID, InEnabled), Input(InSourceNode), Output(InTargetNode), Weight(InWeight) {}
-		explicit ConnectionGene(uint64 InID, uint64 InSourceNode, uint64 InTargetNode, double InWeight) : BaseGene(InID), Input(InSourceNode), Output(InTargetNode), Weight(InWeight) {}
-		ConnectionGene(ConnectionGene&& Other) noexcept : BaseGene(std::move(Other.ID), std::move(Other.Enabled)), Input(std::move(Other.Input)), Output(std::move(Other.Output)), Weight(std::move(Other.Weight)) {}
-		ConnectionGene(const ConnectionGene& Other) : BaseGene(Other.ID, Other.Enabled), Input(Other.Input), Output(Other.Output), Weight(Other.Weight) {}
-		ConnectionGene() = default;
-
-		virtual ~ConnectionGene() = default;
-
-		ConnectionGene& operator=(ConnectionGene&& Other) noexcept { ID = std::move(Other.ID); Enabled = std::move(Other.Enabled); Input = std::move(Other.Input); Output = std::move(Other.Output); Weight = std::move(Other.Weight); return *this; }
-		ConnectionGene& operator=(const ConnectionGene& Other) { ID = Other.ID; Enabled = Other.Enabled; Input = Other.Input; Output = Other.Output; Weight = Other.Weight; return *this; }
-
-		uint64 Input = 0;
-		uint64 Output = 0;
-		double Weight = 1.0;
-	};
-
+	// Genes are trivially copyable values, so that gene arrays are copied and written out as plain memory. The fields are ordered largest first and the
+	// small ones share the last word, which makes a node gene 16 bytes and a connection gene 32. Innovation IDs stay 64-bit, since island ID ranges
+	// and provisional IDs use the high bits (see IslandModel.h and InnovationTracker::Extend).
+	struct NodeGene
+	{
+		uint64 ID = 0;
+		float Bias = 0.0f;
+		EActivation Activation = EActivation::Sigmoid;
+		EAggregation Aggregation = EAggregation::Mean;
+		ENodeType Type = ENodeType::Hidden;
+		bool Enabled = true;
+
+		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation, double InBias, bool InEnabled) : ID(InID), Bias(float(InBias)), Activation(InActivation), Aggregation(InAggregation), Type(InType), Enabled(InEnabled) {}
+		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation, double InBias) : NodeGene(InID, InType, InActivation, InAggregation, InBias, true) {}
+		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, EAggregation InAggregation) : NodeGene(InID, InType, InActivation, InAggregation, 0.0, true) {}
+		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation, double InBias) : NodeGene(InID, InType, InActivation, EAggregation::Mean, InBias, true) {}
+		explicit NodeGene(uint64 InID, ENodeType InType, EActivation InActivation) : NodeGene(InID, InType, InActivation, EAggregation::Mean, 0.0, true) {}
+		NodeGene() = default;
+	};
+
+	static_assert(std::is_trivially_copyable<NodeGene>::value && sizeof(NodeGene) == 16, "NodeGene should be a packed plain value");
+
+	using NodeGenePtr = std::shared_ptr<NodeGene>;
+
+	struct ConnectionGene
+	{
+		uint64 ID = 0;
+		uint64 Input = 0;
+		uint64 Output = 0;
+		float Weight = 1.0f;
+		bool Enabled = true;
+
+		explicit ConnectionGene(uint64 InID, uint64 InSourceNode, uint64 InTargetNode, double InWeight, bool InEnabled) : ID(InID), Input(InSourceNode), Output(InTargetNode), Weight(float(InWeight)), Enabled(InEnabled) {}
+		explicit ConnectionGene(uint64 InID, uint64 InSourceNode, uint64 InTargetNode, double InWeight) : ConnectionGene(InID, InSourceNode, InTargetNode, InWeight, true) {}
+		ConnectionGene() = default;
+	};
+
+	static_assert(std::is_trivially_copyable<ConnectionGene>::value && sizeof(ConnectionGene) == 32, "ConnectionGene should be a packed plain value");
+
 	using ConnectionGenePtr = std::shared_ptr<ConnectionGene>;
 }
\ No newline at end of file
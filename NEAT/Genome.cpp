@@ -7,7 +7,7 @@
 NEAT::NeuralNetworkPtr NEAT::Genome::CreateNeuralNetwork() const
 {
 	if (!Config) return nullptr;
-	return std::make_shared<NeuralNetwork>(std::make_shared<Genome>(*this));
+	return MakeArenaShared<NeuralNetwork>(MakeArenaShared<Genome>(*this));
 }
 
 const NEAT::ConnectionGene* NEAT::Genome::GetConnectionByID(uint64 InID) const
@@ -16,16 +16,6 @@ const NEAT::ConnectionGene* NEAT::Genome::GetConnectionByID(uint64 InID) const
 }
 
 const NEAT::NodeGene* NEAT::Genome::GetNodeByID(uint64 InID) const
-{
-	return Genotype.Nodes.Find(InID);
-}
-
-NEAT::ConnectionGene* NEAT::Genome::GetConnectionByID(uint64 InID)
-{
-	return Genotype.Connections.Find(InID);
-}
-
-NEAT::NodeGene* NEAT::Genome::GetNodeByID(uint64 InID)
 {
 	return Genotype.Nodes.Find(InID);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <string>  
 #include <memory>
+#include <atomic>
 #include <sstream>
 #include "Genotype.h"
 
@@ -23,8 +24,10 @@ namespace NEAT
 		double AdjustedFitness = 0.0;
 		double Fitness = 0.0;
 		bool bElite = false;
+		bool bEvaluated = false; // Fitness is already known for the coming evaluation, set for offspring evaluated by the reproduction pipeline (see Config->PipelinedReproduction). Not copied with the genome
 
-		static unsigned GenerateNewGenomeID() { static unsigned NewestID = 0; return ++NewestID; }
+		static uint64 GenerateNewGenomeID() { return ReserveGenomeIDs(1); } // Numbered by the evolution context bound to the calling thread, atomic
+		static uint64 ReserveGenomeIDs(uint64 Count) { return GetContext().ReserveGenomeIDs(Count); } // Returns the first of Count consecutive IDs, for genomes built in parallel but numbered in order
 		Genome(Genome&& Other) noexcept : ID(std::move(Other.ID)), SpeciesID(std::move(Other.SpeciesID)), Genotype(std::move(Other.Genotype)), Config(std::move(Other.Config)), AdjustedFitness(std::move(Other.AdjustedFitness)), Fitness(std::move(Other.Fitness)), bElite(std::move(Other.bElite)) { }
 		Genome(const Genome& Other) : ID(Other.ID), SpeciesID(Other.SpeciesID), Genotype(Other.Genotype), Config(Other.Config), AdjustedFitness(Other.AdjustedFitness), Fitness(Other.Fitness), bElite(Other.bElite) { }
 		Genome(const ConfigPtr& InConfig, const NEAT::Genotype& InGenotype) : Config(InConfig), Genotype(InGenotype) { }
@@ -68,8 +71,6 @@ namespace NEAT
 
 		const ConnectionGene* GetConnectionByID(uint64 InID) const;
 		const NodeGene* GetNodeByID(uint64 InID) const;
-		ConnectionGene* GetConnectionByID(uint64 InID);
-		NodeGene* GetNodeByID(uint64 InID);
 
 		NeuralNetworkPtr CreateNeuralNetwork() const;
 	};
@@ -5,13 +5,68 @@
 #include "Map.h"
 #include <sstream>
 #include <string>
+#include <cstring>
+#include <unordered_set>
+#include <utility>
 
-NEAT::InnovationTracker NEAT::Innovations = NEAT::InnovationTracker();
+static thread_local NEAT::InnovationTracker* BoundInnovations = nullptr;
+
+namespace
+{
+	constexpr int MaxAddConnectionAttempts = 8; // Node pairs an add connection mutation samples before giving up, so that nearly fully connected genomes can't make it spin
+}
+
+NEAT::InnovationTracker& NEAT::GetInnovations()
+{
+	return BoundInnovations ? *BoundInnovations : GetContext().Innovations;
+}
+
+NEAT::ScopedInnovations::ScopedInnovations(InnovationTracker& Tracker) : PreviousTracker(BoundInnovations)
+{
+	BoundInnovations = &Tracker;
+}
+
+NEAT::ScopedInnovations::~ScopedInnovations()
+{
+	BoundInnovations = PreviousTracker;
+}
+
+// Keeps the hashes and the gene index current across a change made by the Genotype methods, which update them gene by gene. The scope first refreshes them
+// if the maps were changed directly, then writing to the maps flags them as changed, which is undone when the scope ends
+struct NEAT::Genotype::ScopedGeneUpdate
+{
+	ScopedGeneUpdate(Genotype& InGenes) : Genes(InGenes)
+	{
+		if (!Genes.AreIndexesCurrent()) Genes.RefreshIndexes();
+	}
+
+	~ScopedGeneUpdate()
+	{
+		Genes.Nodes.ClearChanged();
+		Genes.Connections.ClearChanged();
+	}
+
+	Genotype& Genes;
+};
 
 // Removes connections that have invalid input or output nodes
 void NEAT::Genotype::Prune()
 {
-	Connections = Connections.FilterByPredicate(ValidConnectionFilter());
+	ScopedGeneUpdate GeneUpdate(*this);
+	RemoveInvalidConnections();
+}
+
+void NEAT::Genotype::RemoveInvalidConnections()
+{
+	const auto IsValid = ValidConnectionFilter();
+	bool bAnyInvalid = false;
+	for (const auto& ConnectionPair : std::as_const(Connections))
+	{
+		if (IsValid(ConnectionPair)) continue;
+		ToggleGeneHash(ConnectionPair.second);
+		bAnyInvalid = true;
+	}
+	if (bAnyInvalid) Connections = Connections.FilterByPredicate(IsValid); // Otherwise the connections stay shared
 }
 
 NEAT::Genotype::ConnectionFilter NEAT::Genotype::ValidConnectionFilter() const
@@ -73,6 +128,36 @@ void NEAT::Genotype::ReduceGeneKeys()
     }
       
     for (const auto& Connection : TempConnections) Connections[Connection.ID] = Connection; // Add the updated connections back to the connection genes map
+    RefreshIndexes();
+}
+
+// Renumbers the genes whose IDs are keys of Remap, e.g. provisional innovations once they were numbered for real (see InnovationTracker::Extend)
+void NEAT::Genotype::RemapGeneKeys(const TMap<uint64, uint64>& Remap)
+{
+	if (Remap.Num() == 0) return;
+	auto RemapID = [&Remap](uint64 ID) { const uint64* NewID = Remap.Find(ID); return NewID ? *NewID : ID; };
+
+	decltype(Nodes) RemappedNodes;
+	for (const auto& NodePair : std::as_const(Nodes)) // Read only, so that a shared array isn't copied just to be replaced
+	{
+		const uint64 NodeID = RemapID(NodePair.first);
+		RemappedNodes[NodeID] = NodePair.second;
+		RemappedNodes[NodeID].ID = NodeID;
+	}
+
+	decltype(Connections) RemappedConnections;
+	for (const auto& ConnectionPair : std::as_const(Connections))
+	{
+		const uint64 ConnectionID = RemapID(ConnectionPair.first);
+		auto& Connection = RemappedConnections[ConnectionID] = ConnectionPair.second;
+		Connection.ID = ConnectionID;
+		Connection.Input = RemapID(Connection.Input);
+		Connection.Output = RemapID(Connection.Output);
+	}
+
+	Nodes = std::move(RemappedNodes);
+	Connections = std::move(RemappedConnections);
+	RefreshIndexes();
 }
 
 /**
@@ -232,6 +317,7 @@ bool NEAT::Genotype::Deserialize(const std::string& Data)
             }
         }
 
+        RefreshIndexes();
         return true; // Return true to indicate success  
     }
     catch (const std::exception& e) // Catch any exceptions  
@@ -246,7 +332,7 @@ bool NEAT::Genotype::Deserialize(const std::string& Data)
  *
  * @return The serialized genotype definition.
  */
-std::string NEAT::Genotype::Serialize()
+std::string NEAT::Genotype::Serialize() const
 {
     std::string yamlStr;
 
@@ -274,12 +360,251 @@ std::string NEAT::Genotype::Serialize()
     return yamlStr; // Return the serialized genotype definition  
 }
 
+/**
+ * Appends a compact binary encoding of the genotype: the node count and nodes, followed by the connection count and connections.
+ *
+ * @param OutData The buffer the encoding is appended to.
+ */
+void NEAT::Genotype::SerializeBinary(std::vector<uint8>& OutData) const
+{
+	WriteBinary(OutData, uint32(Nodes.Num()));
+	for (const auto& NodePair : Nodes) WriteBinary(OutData, NodePair.second); // Genes are plain values, see Genes.h
+
+	WriteBinary(OutData, uint32(Connections.Num()));
+	for (const auto& ConnectionPair : Connections) WriteBinary(OutData, ConnectionPair.second);
+}
+
+/**
+ * Reads a genotype written by SerializeBinary, replacing the current genes.
+ *
+ * @param Data The buffer holding the encoding.
+ * @param Size The size of the buffer.
+ * @param Offset The read position, advanced past the genotype on success.
+ * @return True if the genotype was successfully read, false if the data was truncated.
+ */
+bool NEAT::Genotype::DeserializeBinary(const uint8* Data, size_t Size, size_t& Offset)
+{
+	Nodes.Reset();
+	Connections.Reset();
+
+	uint32 NumNodes = 0;
+	if (!ReadBinary(Data, Size, Offset, NumNodes)) return false;
+	Nodes.Reserve(int(NumNodes));
+	for (uint32 Idx = 0; Idx != NumNodes; ++Idx)
+	{
+		NEAT::NodeGene Node;
+		if (!ReadBinary(Data, Size, Offset, Node)) return false;
+		Nodes[Node.ID] = Node;
+	}
+
+	uint32 NumConnections = 0;
+	if (!ReadBinary(Data, Size, Offset, NumConnections)) return false;
+	Connections.Reserve(int(NumConnections));
+	for (uint32 Idx = 0; Idx != NumConnections; ++Idx)
+	{
+		NEAT::ConnectionGene Connection;
+		if (!ReadBinary(Data, Size, Offset, Connection)) return false;
+		Connections[Connection.ID] = Connection;
+	}
+
+	RefreshIndexes();
+	return true;
+}
+
+namespace
+{
+	uint64 CombineHash(uint64 Hash, uint64 Value)
+	{
+		Hash ^= Value + 0x9E3779B97F4A7C15ull + (Hash << 6) + (Hash >> 2);
+		return (Hash ^ (Hash >> 31)) * 0xBF58476D1CE4E5B9ull;
+	}
+
+	uint64 FloatBits(float Value)
+	{
+		uint32 Bits = 0;
+		std::memcpy(&Bits, &Value, sizeof(Bits));
+		return Bits;
+	}
+
+	// Nodes and connections start from different seeds, so that a node and a connection with the same fields don't cancel out
+	uint64 StructuralGeneHash(const NEAT::NodeGene& Node)
+	{
+		return CombineHash(CombineHash(0x84222325CBF29CE4ull, Node.ID), uint64(Node.Enabled) | (uint64(Node.Type) << 8) | (uint64(Node.Activation) << 16) | (uint64(Node.Aggregation) << 24));
+	}
+
+	uint64 StructuralGeneHash(const NEAT::ConnectionGene& Connection)
+	{
+		return CombineHash(CombineHash(CombineHash(CombineHash(0xC2B2AE3D27D4EB4Full, Connection.ID), Connection.Input), Connection.Output), uint64(Connection.Enabled));
+	}
+
+	uint64 FullGeneHash(const NEAT::NodeGene& Node)
+	{
+		return CombineHash(StructuralGeneHash(Node), FloatBits(Node.Bias));
+	}
+
+	uint64 FullGeneHash(const NEAT::ConnectionGene& Connection)
+	{
+		return CombineHash(StructuralGeneHash(Connection), FloatBits(Connection.Weight));
+	}
+}
+
+/**
+ * Computes the hashes of the genotype from every gene. Each hash is the XOR of the hashes of the genes, so it only depends on the genes themselves,
+ * and adding, removing or changing a gene updates it in O(1). Floating point fields are hashed by their bit patterns, so any change to a weight or bias changes the full hash.
+ *
+ * @param OutStructuralHash The hash of the topology, see GetStructuralHash.
+ * @param OutFullHash The hash of every gene field.
+ */
+void NEAT::Genotype::ComputeHashes(uint64& OutStructuralHash, uint64& OutFullHash) const
+{
+	OutStructuralHash = 0;
+	OutFullHash = 0;
+	for (const auto& NodePair : Nodes)
+	{
+		OutStructuralHash ^= StructuralGeneHash(NodePair.second);
+		OutFullHash ^= FullGeneHash(NodePair.second);
+	}
+
+	for (const auto& ConnectionPair : Connections)
+	{
+		OutStructuralHash ^= StructuralGeneHash(ConnectionPair.second);
+		OutFullHash ^= FullGeneHash(ConnectionPair.second);
+	}
+}
+
+uint64 NEAT::Genotype::ComputeHash() const
+{
+	uint64 Structural = 0, Full = 0;
+	ComputeHashes(Structural, Full);
+	return Full;
+}
+
+uint64 NEAT::Genotype::GetStructuralHash() const
+{
+	if (AreIndexesCurrent()) return StructuralHash;
+	uint64 Structural = 0, Full = 0;
+	ComputeHashes(Structural, Full);
+	return Structural;
+}
+
+uint64 NEAT::Genotype::GetFullHash() const
+{
+	return AreIndexesCurrent() ? FullHash : ComputeHash();
+}
+
+void NEAT::Genotype::RefreshIndexes()
+{
+	ComputeHashes(StructuralHash, FullHash);
+	IndexNodes();
+	Nodes.ClearChanged();
+	Connections.ClearChanged();
+}
+
+void NEAT::Genotype::ToggleGeneHash(const NEAT::NodeGene& Node)
+{
+	StructuralHash ^= StructuralGeneHash(Node);
+	FullHash ^= FullGeneHash(Node);
+}
+
+void NEAT::Genotype::ToggleGeneHash(const NEAT::ConnectionGene& Connection)
+{
+	StructuralHash ^= StructuralGeneHash(Connection);
+	FullHash ^= FullGeneHash(Connection);
+}
+
+void NEAT::Genotype::IndexNodes()
+{
+	NodeTypes = NodeTypeIndex();
+	for (int NodeIdx = 0, NumNodes = Nodes.Num(); NodeIdx != NumNodes; ++NodeIdx)
+	{
+		const int Type = int(std::as_const(Nodes).GetValueAt(NodeIdx).Type);
+		if (NodeTypes.Num[Type] == 0) NodeTypes.Begin[Type] = NodeIdx;
+		else if (NodeTypes.Begin[Type] + NodeTypes.Num[Type] != NodeIdx) NodeTypes.bContiguous = false; // Nodes of another type sit between the nodes of this one
+		NodeTypes.Num[Type]++;
+	}
+}
+
+void NEAT::Genotype::IndexAddedNode(int NodeIdx, ENodeType Type)
+{
+	const int AddedType = int(Type);
+	if (NodeTypes.bContiguous)
+	{
+		for (int OtherType = 0; OtherType != 3; ++OtherType)
+		{
+			if (OtherType == AddedType || NodeTypes.Num[OtherType] == 0) continue;
+			const int Begin = NodeTypes.Begin[OtherType];
+			if (NodeIdx > Begin && NodeIdx < Begin + NodeTypes.Num[OtherType]) NodeTypes.bContiguous = false; // Inserted between nodes of another type
+			else if (NodeIdx <= Begin) NodeTypes.Begin[OtherType]++;
+		}
+
+		if (NodeTypes.Num[AddedType] == 0) NodeTypes.Begin[AddedType] = NodeIdx;
+		else if (NodeIdx < NodeTypes.Begin[AddedType] || NodeIdx > NodeTypes.Begin[AddedType] + NodeTypes.Num[AddedType]) NodeTypes.bContiguous = false; // Apart from the other nodes of its type
+	}
+	NodeTypes.Num[AddedType]++;
+}
+
+void NEAT::Genotype::IndexRemovedNode(int NodeIdx, ENodeType Type)
+{
+	NodeTypes.Num[int(Type)]--;
+	if (!NodeTypes.bContiguous) return;
+	for (int OtherType = 0; OtherType != 3; ++OtherType)
+	{
+		if (NodeTypes.Begin[OtherType] > NodeIdx) NodeTypes.Begin[OtherType]--;
+	}
+}
+
+int NEAT::Genotype::GetNodeIndexOfType(ENodeType Type, int Idx) const
+{
+	if (NodeTypes.bContiguous) return NodeTypes.Begin[int(Type)] + Idx;
+
+	for (int NodeIdx = 0, NumNodes = Nodes.Num(), NumSeen = 0; NodeIdx != NumNodes; ++NodeIdx)
+	{
+		if (Nodes.GetValueAt(NodeIdx).Type == Type && NumSeen++ == Idx) return NodeIdx;
+	}
+	return -1;
+}
+
+uint64 NEAT::Genotype::GetRandomNode(ENodeType FirstType, ENodeType SecondType) const
+{
+	const int NumFirst = NodeTypes.Num[int(FirstType)];
+	const int Idx = GetRandomIndex(NumFirst + NodeTypes.Num[int(SecondType)]);
+	const int NodeIdx = Idx < NumFirst ? GetNodeIndexOfType(FirstType, Idx) : GetNodeIndexOfType(SecondType, Idx - NumFirst);
+	return Nodes.GetPairAt(NodeIdx).first;
+}
+
+void NEAT::Genotype::GatherSuccessors(TMap<uint64, TArray<uint64>>& Successors) const
+{
+	for (const auto& ConnectionPair : Connections) Successors[ConnectionPair.second.Input].Add(ConnectionPair.second.Output); // Disabled connections too, they may be enabled again
+}
+
+bool NEAT::Genotype::IsReachable(uint64 FromID, uint64 ToID, TMap<uint64, TArray<uint64>>& Successors) const
+{
+	if (FromID == ToID) return true;
+	if (Successors.Num() == 0) GatherSuccessors(Successors);
+
+	TArray<uint64> Pending = { FromID };
+	std::unordered_set<uint64> Visited = { FromID };
+	while (!Pending.IsEmpty())
+	{
+		const uint64 NodeID = Pending.Last();
+		Pending.RemoveAt(Pending.Num() - 1);
+		const TArray<uint64>* NodeSuccessors = Successors.Find(NodeID);
+		if (!NodeSuccessors) continue;
+		for (uint64 SuccessorID : *NodeSuccessors)
+		{
+			if (SuccessorID == ToID) return true;
+			if (Visited.insert(SuccessorID).second) Pending.Add(SuccessorID);
+		}
+	}
+	return false;
+}
+
 void NEAT::Genotype::Mutate(const ConfigPtr& Config)
 {
 	if (Config->SingleMutation)
 	{
 		// Choose a random mutation
-		switch (static_cast<EMutationType>(rand() % static_cast<int>(EMutationType::MAX)))
+		switch (static_cast<EMutationType>(GetRandomIndex(static_cast<int>(EMutationType::MAX))))
 		{
 		case EMutationType::AddNode: if (Math::Random<double>(1.0) < Config->AddNodeMutationRate) MutateAddNode(Config); break;
 		case EMutationType::AddConnection: if (Math::Random<double>(1.0) < Config->AddConnectionMutationRate) MutateAddConnection(Config); break;
@@ -290,6 +615,7 @@ void NEAT::Genotype::Mutate(const ConfigPtr& Config)
 		case EMutationType::ModifyActivation: if (Math::Random<double>(1.0) < Config->ActivationFunctionMutationRate) MutateModifyActivation(Config); break;
 		case EMutationType::ModifyAggregation: if (Math::Random<double>(1.0) < Config->AggregationFunctionMutationRate) MutateModifyAggregation(Config); break;
 		case EMutationType::ToggleConnection: if (Math::Random<double>(1.0) < Config->EnableMutationRate) MutateToggleConnection(Config); break;
+		default: break; // MAX is never drawn
 		}
 	}
 	else
@@ -309,58 +635,81 @@ void NEAT::Genotype::Mutate(const ConfigPtr& Config)
 
 bool NEAT::Genotype::MutateAddNode(const NEAT::ConfigPtr& Config)
 {
+	ScopedGeneUpdate GeneUpdate(*this);
 	if (Connections.IsEmpty()) return false; // No connections to split
-	const auto ConnectionID = Connections.GetKeys()[rand() % Connections.Num()]; // Find a random connection ID
-	auto& Connection = Connections[ConnectionID]; // Find the connection
+	auto& Connection = Connections.GetValueAt(GetRandomIndex(Connections.Num())); // Find a random connection
+	ToggleGeneHash(Connection);
 	Connection.Enabled = false; // Disable the old connection
-	auto NodeID = Innovations.GetInnovationID(EMutationType::AddNode, EGeneType::Node, Connection.Input, Connection.Output); // Get the new Node ID
-	auto InputID = Innovations.GetInnovationID(EMutationType::AddNode, EGeneType::Connection, Connection.Input, NodeID); // Get the ID for the connection from old input to new node
-	auto OutputID = Innovations.GetInnovationID(EMutationType::AddNode, EGeneType::Connection, NodeID, Connection.Output); // Get the ID for the connection from new node to old output
+	ToggleGeneHash(Connection);
+	const NEAT::ConnectionGene Split = Connection; // Adding the new genes below moves the connection
+	auto NodeID = GetInnovations().GetInnovationID(EMutationType::AddNode, EGeneType::Node, Split.Input, Split.Output); // Get the new Node ID
+	auto InputID = GetInnovations().GetInnovationID(EMutationType::AddNode, EGeneType::Connection, Split.Input, NodeID); // Get the ID for the connection from old input to new node
+	auto OutputID = GetInnovations().GetInnovationID(EMutationType::AddNode, EGeneType::Connection, NodeID, Split.Output); // Get the ID for the connection from new node to old output
 	if (Nodes.Contains(NodeID)) return false; // Node already exists
-    Nodes[NodeID] = NodeGene(NodeID, ENodeType::Hidden, Config->DefaultActivationFunction, Config->DefaultAggregationFunction, 0.0); // Create a new node
-	Connections[InputID] = ConnectionGene(InputID, Connection.Input, NodeID, 1.0); // Create a new connection from the old source node to the new node
-	Connections[OutputID] = ConnectionGene(OutputID, NodeID, Connection.Output, Connection.Weight); // Create a new connection from the new node to the old target node
+    ToggleGeneHash(Nodes[NodeID] = NodeGene(NodeID, ENodeType::Hidden, Config->DefaultActivationFunction, Config->DefaultAggregationFunction, 0.0)); // Create a new node
+	ToggleGeneHash(Connections[InputID] = ConnectionGene(InputID, Split.Input, NodeID, 1.0)); // Create a new connection from the old source node to the new node
+	ToggleGeneHash(Connections[OutputID] = ConnectionGene(OutputID, NodeID, Split.Output, Split.Weight)); // Create a new connection from the new node to the old target node
+	IndexAddedNode(Nodes.IndexOf(NodeID), ENodeType::Hidden);
     return true;
 }
 
 bool NEAT::Genotype::MutateAddConnection(const NEAT::ConfigPtr& Config)
 {
-	const auto& NodesIDs = Nodes.GetKeys(); // Get all node IDs
-	if (NodesIDs.IsEmpty()) return false; // No nodes to connect
-	auto Node1ID = NodesIDs[rand() % NodesIDs.Num()]; // Find first random node
-	while (Nodes[Node1ID].Type == ENodeType::Output) Node1ID = NodesIDs[rand() % NodesIDs.Num()]; // Don't connect output to anything
-	auto Node2ID = NodesIDs[rand() % NodesIDs.Num()]; // Find second random node
-	while (Nodes[Node2ID].Type == ENodeType::Input) Node2ID = NodesIDs[rand() % NodesIDs.Num()]; // Don't connect anything to input
-	auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, Node1ID, Node2ID); // Get the new connection ID
-	if (Connections.Contains(ConnectionID)) return false; // Connection already exists
-	Connections[ConnectionID] = ConnectionGene(ConnectionID, Node1ID, Node2ID, 1.0); // Create a new connection
-	return true;
+	ScopedGeneUpdate GeneUpdate(*this);
+	const int NumHidden = NodeTypes.Num[int(ENodeType::Hidden)];
+	if (NodeTypes.Num[int(ENodeType::Input)] + NumHidden == 0 || NumHidden + NodeTypes.Num[int(ENodeType::Output)] == 0) return false; // No nodes to connect
+
+	// Existing edges are found by their nodes, since edges split by MutateAddNode or inherited through crossover have other innovation IDs than the one
+	// the tracker would give the pair here. The tracker is only asked for an ID once the edge is known to be new
+	TMap<uint64, TArray<uint64>> Successors;
+	GatherSuccessors(Successors);
+	for (int Attempt = 0; Attempt != MaxAddConnectionAttempts; ++Attempt)
+	{
+		const uint64 Node1ID = GetRandomNode(ENodeType::Input, ENodeType::Hidden); // Don't connect output to anything
+		const uint64 Node2ID = GetRandomNode(ENodeType::Hidden, ENodeType::Output); // Don't connect anything to input
+		const TArray<uint64>* Node1Successors = Successors.Find(Node1ID);
+		if (Node1Successors && Node1Successors->Contains(Node2ID)) continue; // Already connected
+		if (Config->FeedForward && IsReachable(Node2ID, Node1ID, Successors)) continue; // Would close a cycle
+
+		auto ConnectionID = GetInnovations().GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, Node1ID, Node2ID); // Get the new connection ID, the same one if other genomes connected the nodes before
+		ToggleGeneHash(Connections[ConnectionID] = ConnectionGene(ConnectionID, Node1ID, Node2ID, 1.0)); // Create a new connection
+		return true;
+	}
+	return false;
 }
 
 bool NEAT::Genotype::MutateRemoveNode(const NEAT::ConfigPtr& Config)
 {
-	auto HiddenNodeKeys = GetFilteredNodeKeys([](const auto& Node) { return Node.second.Type != ENodeType::Input && Node.second.Type != ENodeType::Output; });
-	if (HiddenNodeKeys.IsEmpty()) return false; // No hidden nodes to remove
-	auto NodeID = HiddenNodeKeys[rand() % HiddenNodeKeys.Num()]; // Get random hidden node
-	Nodes.Remove(NodeID); // Remove the node
-	Prune(); // Remove invalid connections
+	ScopedGeneUpdate GeneUpdate(*this);
+	const int NumHidden = NodeTypes.Num[int(ENodeType::Hidden)];
+	if (NumHidden == 0) return false; // No hidden nodes to remove
+	const int NodeIdx = GetNodeIndexOfType(ENodeType::Hidden, GetRandomIndex(NumHidden)); // Get random hidden node
+	ToggleGeneHash(std::as_const(Nodes).GetValueAt(NodeIdx));
+	IndexRemovedNode(NodeIdx, ENodeType::Hidden);
+	Nodes.RemoveAt(NodeIdx); // Remove the node
+	RemoveInvalidConnections(); // Remove the connections of the node
 	return true;
 }
 
 bool NEAT::Genotype::MutateRemoveConnection(const NEAT::ConfigPtr& Config)
 {
 	if (Connections.IsEmpty()) return false; // No connections to remove
-	auto ConnectionID = Connections.GetKeys()[rand() % Connections.Num()]; // Get random connection
-	Connections.Remove(ConnectionID); // Remove the connection
+	const int ConnectionIdx = GetRandomIndex(Connections.Num()); // Get random connection
+	ScopedGeneUpdate GeneUpdate(*this);
+	ToggleGeneHash(std::as_const(Connections).GetValueAt(ConnectionIdx));
+	Connections.RemoveAt(ConnectionIdx); // Remove the connection
 	return true;
 }
 
 bool NEAT::Genotype::MutateModifyWeight(const NEAT::ConfigPtr& Config)
 {
 	if (Connections.IsEmpty()) return false; // No connections to modify
-	auto ConnectionID = Connections.GetKeys()[rand() % Connections.Num()]; // Get random connection
-	auto& Connection = Connections[ConnectionID]; // Get the connection
-	Connection.Weight = Math::Clamp(Connection.Weight + GetRandomDouble(-Config->WeightMutationVariance, Config->WeightMutationVariance), Config->MinConnectionWeight, Config->MaxConnectionWeight); // Modify the connection weight
+	const int ConnectionIdx = GetRandomIndex(Connections.Num()); // Get random connection
+	ScopedGeneUpdate GeneUpdate(*this);
+	auto& Connection = Connections.GetValueAt(ConnectionIdx); // Get the connection
+	ToggleGeneHash(Connection);
+	Connection.Weight = float(Math::Clamp(Connection.Weight + GetRandomDouble(-Config->WeightMutationVariance, Config->WeightMutationVariance), Config->MinConnectionWeight, Config->MaxConnectionWeight)); // Modify the connection weight
+	ToggleGeneHash(Connection);
 	return true;
 }
 
@@ -368,42 +717,50 @@ bool NEAT::Genotype::MutateModifyBias(const NEAT::ConfigPtr& Config)
 {
 	//auto HiddenNodeKeys = GetFilteredNodeKeys([](const auto& Node) { return Node.second.Type != ENodeType::Input && Node.second.Type != ENodeType::Output; });
 	//if (HiddenNodeKeys.IsEmpty()) return false; // No hidden nodes to modify
-	//auto NodeID = HiddenNodeKeys[rand() % HiddenNodeKeys.Num()]; // Get random hidden node
-	auto NodeID = Nodes.GetKeys()[rand() % Nodes.Num()]; // Get random node
-	auto& Node = Nodes[NodeID]; // Get the node
-	Node.Bias = Math::Clamp(Node.Bias + GetRandomDouble(-Config->BiasMutationVariance, Config->BiasMutationVariance), Config->MinNodeBias, Config->MaxNodeBias); // Modify the node bias
+	//auto NodeID = HiddenNodeKeys[GetRandomIndex(HiddenNodeKeys.Num())]; // Get random hidden node
+	const int NodeIdx = GetRandomIndex(Nodes.Num()); // Get random node
+	ScopedGeneUpdate GeneUpdate(*this);
+	auto& Node = Nodes.GetValueAt(NodeIdx); // Get the node
+	ToggleGeneHash(Node);
+	Node.Bias = float(Math::Clamp(Node.Bias + GetRandomDouble(-Config->BiasMutationVariance, Config->BiasMutationVariance), Config->MinNodeBias, Config->MaxNodeBias)); // Modify the node bias
+	ToggleGeneHash(Node);
 	return false;
 }
 
 bool NEAT::Genotype::MutateModifyActivation(const NEAT::ConfigPtr& Config)
 {
-	TArray<EActivation> SupportedActivations = Config->SupportedActivationFunctions;
-	SupportedActivations.AddUnique(Config->DefaultActivationFunction); // Add the default activation function, so there is at least always that to select from
-	auto HiddenNodeKeys = GetFilteredNodeKeys([](const auto& Node) { return Node.second.Type != ENodeType::Input; });
-	if (HiddenNodeKeys.IsEmpty()) return false; // No hidden nodes to modify
-	auto NodeID = HiddenNodeKeys[rand() % HiddenNodeKeys.Num()]; // Get random hidden node
-	auto& Node = Nodes[NodeID]; // Get the node
-	Node.Activation = SupportedActivations[rand() % SupportedActivations.Num()]; // Modify the node activation function
+	ScopedGeneUpdate GeneUpdate(*this);
+	if (NodeTypes.Num[int(ENodeType::Hidden)] + NodeTypes.Num[int(ENodeType::Output)] == 0) return false; // No hidden nodes to modify
+	const auto Tables = Config->GetMutationTables(); // Held until the mutation is done, in case the config prepares new tables meanwhile
+	const TArray<EActivation>& SupportedActivations = Tables->Activations; // Includes the default activation function, so there is at least always that to select from
+	auto& Node = Nodes[GetRandomNode(ENodeType::Hidden, ENodeType::Output)]; // Get random hidden node
+	ToggleGeneHash(Node);
+	Node.Activation = SupportedActivations[GetRandomIndex(SupportedActivations.Num())]; // Modify the node activation function
+	ToggleGeneHash(Node);
 	return false;
 }
 
 bool NEAT::Genotype::MutateModifyAggregation(const NEAT::ConfigPtr& Config)
 {
-	TArray<EAggregation> SupportedAggregations = Config->SupportedAggregationFunctions;
-	SupportedAggregations.AddUnique(Config->DefaultAggregationFunction); // Add the default aggregation function, so there is at least always that to select from
-	auto HiddenNodeKeys = GetFilteredNodeKeys([](const auto& Node) { return Node.second.Type != ENodeType::Input; });
-	if (HiddenNodeKeys.IsEmpty()) return false; // No hidden nodes to modify
-	auto NodeID = HiddenNodeKeys[rand() % HiddenNodeKeys.Num()]; // Get random hidden node
-	auto& Node = Nodes[NodeID]; // Get the node
-	Node.Aggregation = SupportedAggregations[rand() % SupportedAggregations.Num()]; // Modify the node aggregation function
+	ScopedGeneUpdate GeneUpdate(*this);
+	if (NodeTypes.Num[int(ENodeType::Hidden)] + NodeTypes.Num[int(ENodeType::Output)] == 0) return false; // No hidden nodes to modify
+	const auto Tables = Config->GetMutationTables(); // Held until the mutation is done, in case the config prepares new tables meanwhile
+	const TArray<EAggregation>& SupportedAggregations = Tables->Aggregations; // Includes the default aggregation function, so there is at least always that to select from
+	auto& Node = Nodes[GetRandomNode(ENodeType::Hidden, ENodeType::Output)]; // Get random hidden node
+	ToggleGeneHash(Node);
+	Node.Aggregation = SupportedAggregations[GetRandomIndex(SupportedAggregations.Num())]; // Modify the node aggregation function
+	ToggleGeneHash(Node);
 	return false;
 }
 
 bool NEAT::Genotype::MutateToggleConnection(const NEAT::ConfigPtr& Config)
 {
 	if (Connections.IsEmpty()) return false; // No connections to toggle
-	auto ConnectionID = Connections.GetKeys()[rand() % Connections.Num()]; // Get random connection
-	auto& Connection = Connections[ConnectionID]; // Get the connection
+	const int ConnectionIdx = GetRandomIndex(Connections.Num()); // Get random connection
+	ScopedGeneUpdate GeneUpdate(*this);
+	auto& Connection = Connections.GetValueAt(ConnectionIdx); // Get the connection
+	ToggleGeneHash(Connection);
 	Connection.Enabled = !Connection.Enabled; // Toggle the connection
+	ToggleGeneHash(Connection);
 	return true;
 }
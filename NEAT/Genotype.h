@@ -3,26 +3,44 @@
 #include <functional>
 #include "Config.h"
 #include "Genes.h"
+#include "EvolutionContext.h"
 #include "Array.h"
 #include "Map.h"
+#include "SortedMap.h"
+#include "Arena.h"
 
 namespace NEAT
 {
-	extern InnovationTracker Innovations;
+	InnovationTracker& GetInnovations(); // Returns the innovation tracker bound to the calling thread, or the tracker of the bound evolution context (see EvolutionContext.h)
+
+	// Binds an innovation tracker to the calling thread for the lifetime of the scope, then restores the previous tracker
+	class ScopedInnovations
+	{
+	public:
+		ScopedInnovations(InnovationTracker& Tracker);
+		~ScopedInnovations();
+
+		ScopedInnovations(const ScopedInnovations&) = delete;
+		ScopedInnovations& operator=(const ScopedInnovations&) = delete;
+
+	private:
+		InnovationTracker* PreviousTracker = nullptr;
+	};
 
 	struct Genotype
 	{
 		using ConnectionFilter = std::function<bool(const std::pair<uint64, NEAT::ConnectionGene>&)>;
 		using NodeFilter = std::function<bool(const std::pair<uint64, NEAT::NodeGene>&)>;
 
-		TMap<uint64, NEAT::NodeGene> Nodes;
-		TMap<uint64, NEAT::ConnectionGene> Connections;
+		TSortedMap<uint64, NEAT::NodeGene, TArenaAllocator<std::pair<uint64, NEAT::NodeGene>>> Nodes; // Sorted by innovation ID in contiguous storage, shared with copies of the genotype until either is changed, see SortedMap.h. Allocated in the generation arena, see Arena.h
+		TSortedMap<uint64, NEAT::ConnectionGene, TArenaAllocator<std::pair<uint64, NEAT::ConnectionGene>>> Connections;
 
 		Genotype() = default;
 		virtual ~Genotype() = default;
 
 		void Prune(); // Removes connections that have invalid input or output nodes
 		void ReduceGeneKeys(); // Reduces the gene keys to the smallest possible values
+		void RemapGeneKeys(const TMap<uint64, uint64>& Remap); // Renumbers the genes, and the nodes connections refer to, whose IDs are keys of Remap
 		void PrintGenotype() const;
 		uint64 GetNewestGeneKey() const;
 		ConnectionFilter ValidConnectionFilter() const;
@@ -30,7 +48,13 @@ namespace NEAT
 		TArray<uint64> GetNodeKeys() const;
 		std::string ToPrettyString() const;
 		bool Deserialize(const std::string& Data);
-		std::string Serialize();
+		std::string Serialize() const;
+		void SerializeBinary(std::vector<uint8>& OutData) const; // Appends a compact binary encoding of the genotype, for transfer between processes of the same build
+		bool DeserializeBinary(const uint8* Data, size_t Size, size_t& Offset); // Reads a genotype written by SerializeBinary and advances Offset, returns false on malformed data
+		uint64 GetStructuralHash() const; // Hashes the topology: every gene with its type, endpoints, functions and enabled flag, but not weights or biases. O(1) while the hashes are current
+		uint64 GetFullHash() const; // Hashes every gene field, structure and weights alike, so identical genotypes hash the same regardless of how they were produced. O(1) while the hashes are current
+		void RefreshIndexes(); // Recomputes the hashes and the node type index from every gene. Only needed after changing Nodes or Connections directly, the Genotype methods keep both current; until then every hash query recomputes the hashes
+		uint64 ComputeHash() const; // Recomputes the full hash from every gene, the value GetFullHash returns
 
 		void Mutate(const ConfigPtr& Config);
 		bool MutateAddNode(const ConfigPtr& Config);
@@ -64,5 +88,40 @@ namespace NEAT
 			}
 			return FilteredKeys;
 		}
+
+	private:
+		struct ScopedGeneUpdate;
+
+		// Where the nodes of each type sit in the sorted node array, so that mutations pick a node of a given type in O(1). Nodes of one type usually have
+		// contiguous IDs, inputs and outputs numbered first and hidden nodes after them. When they don't, bContiguous is cleared and picking scans the nodes instead.
+		// It is a few integers, so copies of the genotype carry it along
+		struct NodeTypeIndex
+		{
+			int Begin[3] = {}; // By ENodeType
+			int Num[3] = {};
+			bool bContiguous = true;
+		};
+
+		// The hashes and the node type index are current while neither gene map was changed outside of the Genotype methods, see ScopedGeneUpdate
+		bool AreIndexesCurrent() const { return !Nodes.IsChanged() && !Connections.IsChanged(); }
+
+		// The hashes are XORs of per-gene hashes, so adding, removing or changing a gene updates them in O(1)
+		void ComputeHashes(uint64& OutStructuralHash, uint64& OutFullHash) const;
+		void ToggleGeneHash(const NEAT::NodeGene& Node); // Adds the gene to the hashes, or removes it if it was added
+		void ToggleGeneHash(const NEAT::ConnectionGene& Connection);
+
+		// The node type index, updated by the Genotype methods as they add and remove nodes
+		void IndexNodes();
+		void IndexAddedNode(int NodeIdx, ENodeType Type); // Called after the node was inserted at NodeIdx in the sorted node array
+		void IndexRemovedNode(int NodeIdx, ENodeType Type); // Called before the node at NodeIdx is removed
+		int GetNodeIndexOfType(ENodeType Type, int Idx) const; // The position in the sorted node array of the Idx-th node of the type
+		uint64 GetRandomNode(ENodeType FirstType, ENodeType SecondType) const; // Picks a node of either type, there must be one
+		void GatherSuccessors(TMap<uint64, TArray<uint64>>& Successors) const; // Maps each node to the outputs of its connections, disabled ones too
+		bool IsReachable(uint64 FromID, uint64 ToID, TMap<uint64, TArray<uint64>>& Successors) const; // Whether a path of connections leads from one node to the other. Successors is filled on first use
+		void RemoveInvalidConnections(); // Prune, for callers that already keep the indexes current
+
+		uint64 StructuralHash = 0;
+		uint64 FullHash = 0;
+		NodeTypeIndex NodeTypes;
 	};
 } // namespace NEAT
\ No newline at end of file
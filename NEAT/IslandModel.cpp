@@ -0,0 +1,170 @@
+#include "IslandModel.h"
+#include "Trainer.h"
+#include "Genome.h"
+#include "Genes.h"
+#include "EvolutionContext.h"
+#include "Config.h"
+#include "Math.h"
+#include "Random.h"
+#include "Utils.h"
+#include <thread>
+
+namespace NEAT
+{
+	namespace
+	{
+		constexpr uint64 IslandInnovationStride = uint64(1) << 40; // Size of the innovation ID range owned by each island
+	}
+
+	struct IslandModel::Island
+	{
+		int Index = 0;
+		TrainerPtr IslandTrainer = nullptr;
+		std::string PopulationMetadata;
+	};
+
+	IslandModel::IslandModel(const ConfigPtr& InConfig, TrainerFactory InFactory)
+		: Config(InConfig)
+		, Factory(std::move(InFactory))
+	{
+	}
+
+	IslandModel::~IslandModel()
+	{
+	}
+
+	void IslandModel::Initialize()
+	{
+		Islands.Reset();
+		const int NumIslands = Math::Max(Config->NumIslands, 1);
+		const uint64 IslandPopulationSize = Math::Max<uint64>(Config->PopulationSize / NumIslands, uint64(Math::Max(Config->MinSpeciesSize, 1)));
+
+		for (int IslandIdx = 0; IslandIdx != NumIslands; ++IslandIdx)
+		{
+			// Islands evaluate on the thread that evolves them, so the other parallel evaluation modes are turned off for them
+			auto IslandConfig = std::make_shared<NEAT::Config>(*Config);
+			IslandConfig->PopulationSize = IslandPopulationSize;
+			IslandConfig->RandomSeed = Config->RandomSeed + IslandIdx;
+			IslandConfig->MultithreadedEvaluation = false;
+			IslandConfig->NumThreads = 1;
+			IslandConfig->SteadyStateEvolution = false;
+			IslandConfig->DistributedEvaluation = false;
+			IslandConfig->ProcessEvaluation = false;
+
+			auto NewIsland = std::make_shared<Island>();
+			NewIsland->Index = IslandIdx;
+			NewIsland->IslandTrainer = Factory(IslandConfig);
+			NewIsland->PopulationMetadata = Trainer::CreatePopulationMetadataFilename("_island" + std::to_string(IslandIdx));
+
+			// Initialized one at a time, Initialize also reseeds the shared default random streams
+			Random::ScopedStream Stream(IslandConfig->RandomSeed, Random::MakeStreamID(0, Random::Island, IslandIdx));
+			NewIsland->IslandTrainer->Initialize();
+			NewIsland->IslandTrainer->Context->Innovations.NextInnovationID += IslandIdx * IslandInnovationStride; // The initial topology is numbered the same on every island, everything after it in the island's own range
+
+			Islands.Add(NewIsland);
+		}
+
+		InitializeRandomSeed(Config->RandomSeed);
+		LogMessage(LogLevel::Info, "Island model initialized with " + std::to_string(NumIslands) + " islands of " + std::to_string(IslandPopulationSize) + " genomes");
+	}
+
+	bool IslandModel::ContinueTraining() const
+	{
+		if (Islands.IsEmpty()) return false;
+		for (const auto& CurrentIsland : Islands)
+		{
+			if (!CurrentIsland->IslandTrainer->ContinueTraining()) return false;
+		}
+		return true;
+	}
+
+	void IslandModel::RunIsland(Island& TargetIsland, unsigned StopGeneration)
+	{
+		Trainer& IslandTrainer = *TargetIsland.IslandTrainer;
+		Random::ScopedStream Stream(IslandTrainer.Config->RandomSeed, Random::MakeStreamID(IslandTrainer.Generation, Random::Island, TargetIsland.Index)); // A fresh stream per epoch, so the run only depends on the seed
+		while (IslandTrainer.Generation < StopGeneration && IslandTrainer.ContinueTraining())
+		{
+			IslandTrainer.RunGeneration(TargetIsland.PopulationMetadata);
+		}
+	}
+
+	void IslandModel::Migrate()
+	{
+		const int NumIslands = Islands.Num();
+		if (NumIslands < 2 || Config->MigrationSize <= 0) return;
+
+		// Pick the emigrants before any island receives migrants. The elites are the only genomes of the new generation that still carry their evaluated fitness
+		TArray<TArray<GenomePtr>> Emigrants;
+		for (const auto& CurrentIsland : Islands)
+		{
+			TArray<GenomePtr> Elites = CurrentIsland->IslandTrainer->Population.FilterByPredicate([](const GenomePtr& Genome) { return Genome->bElite; });
+			Elites.Sort([](const GenomePtr& A, const GenomePtr& B) { return A->Fitness > B->Fitness; });
+			Emigrants.Add(Elites.First(Math::Min(Config->MigrationSize, Elites.Num())));
+		}
+
+		for (int SourceIdx = 0; SourceIdx != NumIslands; ++SourceIdx)
+		{
+			for (int Offset = 1; Offset != NumIslands; ++Offset)
+			{
+				Trainer& Destination = *Islands[(SourceIdx + Offset) % NumIslands]->IslandTrainer;
+				ScopedContext BoundContext(Destination.Context.get()); // Migrants are numbered by the island they join
+				for (const auto& Emigrant : Emigrants[SourceIdx])
+				{
+					auto Migrant = MakeArenaShared<NEAT::Genome>(*Emigrant);
+					Migrant->ID = Genome::GenerateNewGenomeID();
+					Migrant->Config = Destination.Config;
+					Migrant->SpeciesID = 0;
+					Migrant->bElite = false;
+					Destination.Population.Add(Migrant); // Speciated after its evaluation, like a reintroduced best genome
+				}
+
+				if (Config->MigrationTopology == EMigrationTopology::Ring) break;
+			}
+		}
+	}
+
+	void IslandModel::Train()
+	{
+		Initialize();
+		while (ContinueTraining())
+		{
+			const unsigned Generation = Islands[0]->IslandTrainer->Generation;
+			const unsigned StopGeneration = Config->MigrationInterval > 0 ? (Generation / Config->MigrationInterval + 1) * Config->MigrationInterval : unsigned(-1);
+
+			std::vector<std::thread> Threads;
+			for (auto& CurrentIsland : Islands)
+			{
+				Threads.emplace_back([this, CurrentIsland, StopGeneration]() { RunIsland(*CurrentIsland, StopGeneration); });
+			}
+
+			for (auto& Thread : Threads) Thread.join();
+
+			if (ContinueTraining()) Migrate();
+		}
+
+		auto BestIsland = GetBestIsland();
+		if (BestIsland && BestIsland->bHasBestGenome)
+		{
+			LogMessage(LogLevel::Info, "Island model finished, best fitness: " + std::to_string(BestIsland->BestGenome.Fitness));
+		}
+	}
+
+	TrainerPtr IslandModel::GetBestIsland() const
+	{
+		TrainerPtr BestIsland = nullptr;
+		for (const auto& CurrentIsland : Islands)
+		{
+			const auto& IslandTrainer = CurrentIsland->IslandTrainer;
+			if (!IslandTrainer->bHasBestGenome) continue;
+			if (!BestIsland || IslandTrainer->BestGenome.Fitness > BestIsland->BestGenome.Fitness) BestIsland = IslandTrainer;
+		}
+		return BestIsland;
+	}
+
+	TArray<TrainerPtr> IslandModel::GetIslands() const
+	{
+		TArray<TrainerPtr> IslandTrainers;
+		for (const auto& CurrentIsland : Islands) IslandTrainers.Add(CurrentIsland->IslandTrainer);
+		return IslandTrainers;
+	}
+} // namespace NEAT
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "Types.h"
+#include "Array.h"
+
+// Island-model evolution.
+// The population is split into NumIslands sub-populations, each evolved by its own Trainer on its own thread, with its own species, innovation tracker and random stream, so no locks are shared between them.
+// Every MigrationInterval generations the islands are synchronized and each sends copies of its best elites to its neighbours along the migration topology, where they join the next generation like a reintroduced genome.
+// Each island numbers new innovations in its own ID range, so a migrant never carries an innovation ID that means something else on the island it arrives at.
+
+namespace NEAT
+{
+	class Config;
+	//using ConfigPtr = std::shared_ptr<const NEAT::Config>;
+	using ConfigPtr = std::shared_ptr<NEAT::Config>;
+
+	class Genome;
+	using GenomePtr = std::shared_ptr<NEAT::Genome>;
+
+	class Trainer;
+	using TrainerPtr = std::shared_ptr<NEAT::Trainer>;
+
+	enum class EMigrationTopology
+	{
+		Ring, // Each island sends its migrants to the next island
+		AllToAll, // Each island sends its migrants to every other island
+	};
+
+	namespace MigrationTopology
+	{
+		static std::string ToString(EMigrationTopology Topology)
+		{
+			switch (Topology)
+			{
+			case EMigrationTopology::Ring: return "EMigrationTopology::Ring";
+			case EMigrationTopology::AllToAll: return "EMigrationTopology::AllToAll";
+			default: return "EMigrationTopology::Unknown";
+			}
+		}
+
+		static EMigrationTopology FromString(const std::string& Topology)
+		{
+			if (Topology == "EMigrationTopology::Ring") return EMigrationTopology::Ring;
+			if (Topology == "EMigrationTopology::AllToAll") return EMigrationTopology::AllToAll;
+			return EMigrationTopology::Ring;
+		}
+	}
+
+	class IslandModel
+	{
+	public:
+		using TrainerFactory = std::function<TrainerPtr(const ConfigPtr&)>; // Creates the Trainer subclass that evolves one island, from that island's Config
+
+		IslandModel(const ConfigPtr& InConfig, TrainerFactory InFactory);
+		~IslandModel();
+
+		void Initialize(); // Creates the islands and their initial populations
+		bool ContinueTraining() const; // Returns false once any island reached the stopping fitness or the generation limit
+		void Migrate(); // Sends copies of each island's best elites to its neighbours along Config->MigrationTopology
+		void Train(); // Evolves the islands in parallel, migrating every Config->MigrationInterval generations, until ContinueTraining returns false
+
+		TrainerPtr GetBestIsland() const; // Returns the island holding the best genome found so far
+		TArray<TrainerPtr> GetIslands() const;
+
+	private:
+		struct Island; // Per-island trainer and metadata file, defined in IslandModel.cpp
+		using IslandPtr = std::shared_ptr<Island>;
+
+		void RunIsland(Island& TargetIsland, unsigned StopGeneration); // Runs generations on the calling thread until StopGeneration or until the island stops training
+
+		ConfigPtr Config = nullptr;
+		TrainerFactory Factory;
+		TArray<IslandPtr> Islands;
+	};
+} // namespace NEAT
@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <cmath>
+#include "Random.h"
 
 namespace NEAT {
 namespace Math {
@@ -165,7 +166,7 @@ namespace Math {
 	template<typename T>
 	inline T Random(const T& Min, const T& Max)
 	{
-		return Min + (Max - Min) * double(rand()) / RAND_MAX;
+		return Min + (Max - Min) * Random::GetStream().NextDouble();
 	}
 
 	template<typename T>
@@ -183,13 +184,13 @@ namespace Math {
 	template<typename T>
 	inline T RandomSign()
 	{
-		return rand() % 2 == 0 ? T(1) : T(-1);
+		return Random::GetStream().NextBool() ? T(1) : T(-1);
 	}
 
 	template<typename T>
 	inline T RandomBool()
 	{
-		return rand() % 2 == 0;
+		return Random::GetStream().NextBool();
 	}
 
 	template<typename T>
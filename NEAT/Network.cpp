@@ -41,33 +41,34 @@ double NeuralNetwork::NeuronConnection::GetWeightedInput() const
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 NeuralNetwork::NeuralNetwork(GenomePtr Genome) : Config(Genome->Config)
 {
-	const auto& InputNodeIDs = Genome->Genotype.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Input; });
-	const auto& HiddenNodeIDs = Genome->Genotype.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Hidden; });
-	const auto& OutputNodeIDs = Genome->Genotype.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Output; });
+	const NEAT::Genotype& Genes = Genome->Genotype; // Read only, so that the genes stay shared with the genome the network was built from
+	const auto& InputNodeIDs = Genes.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Input; });
+	const auto& HiddenNodeIDs = Genes.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Hidden; });
+	const auto& OutputNodeIDs = Genes.GetFilteredNodeKeys([](const auto& Pair) { return Pair.second.Type == ENodeType::Output; });
 
 	for (const auto& NodeID : InputNodeIDs)
 	{
-		const auto& Node = Genome->Genotype.Nodes[NodeID];
-		InputNeurons.Add(std::make_shared<NeuronNode>(Node));
+		const auto& Node = Genes.Nodes[NodeID];
+		InputNeurons.Add(MakeArenaShared<NeuronNode>(Node));
 	}
 
 	for (const auto& NodeID : HiddenNodeIDs)
 	{
-		const auto& Node = Genome->Genotype.Nodes[NodeID];
-		HiddenNeurons.Add(std::make_shared<NeuronNode>(Node));
+		const auto& Node = Genes.Nodes[NodeID];
+		HiddenNeurons.Add(MakeArenaShared<NeuronNode>(Node));
 	}
 
 	for (const auto& NodeID : OutputNodeIDs)
 	{
-		const auto& Node = Genome->Genotype.Nodes[NodeID];
-		OutputNeurons.Add(std::make_shared<NeuronNode>(Node));
+		const auto& Node = Genes.Nodes[NodeID];
+		OutputNeurons.Add(MakeArenaShared<NeuronNode>(Node));
 	}
 
-	for (const auto& Connection : Genome->Genotype.Connections)
+	for (const auto& Connection : Genes.Connections)
 	{
 		auto InputNeuron = GetNeuronByID(Connection.second.Input);
 		auto OutputNeuron = GetNeuronByID(Connection.second.Output);
-		Connections.Add(std::make_shared<NeuronConnection>(InputNeuron, OutputNeuron, Connection.second.Weight));
+		Connections.Add(MakeArenaShared<NeuronConnection>(InputNeuron, OutputNeuron, Connection.second.Weight));
 	}
 }
 
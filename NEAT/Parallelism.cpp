@@ -0,0 +1,107 @@
+#include "Parallelism.h"
+#include "Config.h"
+#include "Math.h"
+#include "Timer.h"
+#include "EvolutionContext.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace NEAT
+{
+	namespace
+	{
+		constexpr double CostSmoothing = 0.3; // Weight of the latest measurement in the moving average
+		constexpr int ChunksPerThread = 4; // Chunks each thread gets when the cost is even, the spare ones absorb uneven genomes
+	}
+
+	ParallelPlan ParallelismTuner::PlanUnmeasured(const NEAT::Config& Config, int NumItems)
+	{
+		ParallelPlan Result;
+		const int MaxThreads = Config.MultithreadedEvaluation ? Math::Min(Config.GetNumThreads(), NumItems) : 1;
+		if (MaxThreads <= 1)
+		{
+			Result.ChunkSize = Math::Max(NumItems, 1);
+			return Result;
+		}
+
+		Result.NumThreads = MaxThreads;
+		Result.ChunkSize = Math::Max(NumItems / (MaxThreads * ChunksPerThread), 1);
+		return Result;
+	}
+
+	ParallelPlan ParallelismTuner::Plan(const NEAT::Config& Config, EParallelPhase Phase, int NumItems) const
+	{
+		ParallelPlan Result = PlanUnmeasured(Config, NumItems);
+		const double ItemCost = ItemCosts[int(Phase)];
+		if (Result.NumThreads <= 1 || !Config.AdaptiveParallelism || ItemCost <= 0.0) return Result; // Serial, or not measured yet and run in parallel to measure it
+		const int MaxThreads = Result.NumThreads;
+
+		const double Grain = Math::Max(Config.ParallelGrainMicroseconds, 1) * 1e-6;
+		const double TotalCost = ItemCost * NumItems;
+		Result.NumThreads = Math::Clamp(int(TotalCost / Grain), 1, MaxThreads);
+		if (Result.NumThreads == 1)
+		{
+			Result.ChunkSize = NumItems;
+			return Result;
+		}
+
+		// Small enough chunks to balance the threads, but each worth at least a fraction of the grain so that claiming chunks stays cheap
+		const int BalancedChunk = Math::Max(NumItems / (Result.NumThreads * ChunksPerThread), 1);
+		const int MinChunk = Math::Max(int(Grain / ChunksPerThread / ItemCost), 1);
+		Result.ChunkSize = Math::Min(Math::Max(BalancedChunk, MinChunk), (NumItems + Result.NumThreads - 1) / Result.NumThreads);
+		return Result;
+	}
+
+	void ParallelismTuner::Record(EParallelPhase Phase, int NumItems, uint64 WorkNanoseconds)
+	{
+		if (NumItems <= 0) return;
+
+		const double ItemCost = WorkNanoseconds * 1e-9 / NumItems;
+		double& AverageCost = ItemCosts[int(Phase)];
+		AverageCost = AverageCost > 0.0 ? AverageCost + CostSmoothing * (ItemCost - AverageCost) : ItemCost;
+	}
+
+	double ParallelismTuner::GetItemCost(EParallelPhase Phase) const
+	{
+		return ItemCosts[int(Phase)];
+	}
+
+	uint64 ParallelFor(const ParallelPlan& Plan, int NumItems, EThreadAffinity Placement, const std::function<void(int, int)>& Body)
+	{
+		std::atomic<int> NextIdx = 0;
+		std::atomic<uint64> WorkNanoseconds = 0;
+		const int ChunkSize = Math::Max(Plan.ChunkSize, 1);
+
+		auto RunChunks = [&]()
+		{
+			Benchmark::Timer WorkTimer("ParallelFor", true);
+			for (int StartIdx = NextIdx.fetch_add(ChunkSize); StartIdx < NumItems; StartIdx = NextIdx.fetch_add(ChunkSize))
+			{
+				Body(StartIdx, Math::Min(StartIdx + ChunkSize, NumItems));
+			}
+			WorkNanoseconds += WorkTimer.GetNanosecondsElapsed();
+		};
+
+		if (Plan.NumThreads <= 1)
+		{
+			RunChunks();
+			return WorkNanoseconds;
+		}
+
+		EvolutionContext* Context = GetBoundContext(); // The workers number genes and genomes for the caller's trainer
+		std::vector<std::thread> Threads;
+		for (int Idx = 0; Idx != Plan.NumThreads; ++Idx)
+		{
+			Threads.emplace_back([&, Idx]()
+			{
+				ScopedContext BoundContext(Context);
+				Affinity::PinWorker(Placement, Idx, Plan.NumThreads);
+				RunChunks();
+			});
+		}
+
+		for (auto& Thread : Threads) Thread.join();
+		return WorkNanoseconds;
+	}
+} // namespace NEAT
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include "Types.h"
+#include "Affinity.h"
+
+// Online sizing of the trainer's parallel phases.
+// Each phase records how much work it did per item, as an exponential moving average over generations, and the next run of the phase gets as many threads
+// as it has Config->ParallelGrainMicroseconds worth of work for, and chunks small enough to balance the load. Phases too small to pay for starting threads run serially.
+
+namespace NEAT
+{
+	class Config;
+
+	enum class EParallelPhase
+	{
+		Evaluation,
+		Speciation,
+		Initialization,
+		Pipeline,
+		Num,
+	};
+
+	// How a phase is split: the number of threads that run it and the number of items each thread claims at a time
+	struct ParallelPlan
+	{
+		int NumThreads = 1;
+		int ChunkSize = 1;
+	};
+
+	class ParallelismTuner
+	{
+	public:
+		ParallelPlan Plan(const NEAT::Config& Config, EParallelPhase Phase, int NumItems) const; // Splits NumItems items of the phase, from the cost measured so far
+		static ParallelPlan PlanUnmeasured(const NEAT::Config& Config, int NumItems); // Splits NumItems items from the config alone, so the split is the same on every run
+		void Record(EParallelPhase Phase, int NumItems, uint64 WorkNanoseconds); // Records a completed run of the phase, WorkNanoseconds summed over the threads that ran it
+		double GetItemCost(EParallelPhase Phase) const; // The average cost of one item of the phase in seconds, zero until the phase was measured
+
+	private:
+		double ItemCosts[int(EParallelPhase::Num)] = {};
+	};
+
+	// Runs Body(StartIdx, EndIdx) over chunks of [0, NumItems), claimed by Plan.NumThreads worker threads placed by Placement, or on the calling thread for single-threaded plans.
+	// Returns the time spent running Body, summed over the threads, for ParallelismTuner::Record
+	uint64 ParallelFor(const ParallelPlan& Plan, int NumItems, EThreadAffinity Placement, const std::function<void(int, int)>& Body);
+} // namespace NEAT
@@ -0,0 +1,296 @@
+#include "ProcessWorkers.h"
+#include "Trainer.h"
+#include "Genome.h"
+#include "Config.h"
+#include "Random.h"
+#include "Utils.h"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace NEAT
+{
+	namespace
+	{
+		// Slot states, a claimed slot stores ClaimedBase + the index of the worker evaluating it
+		constexpr uint32 SlotEmpty = 0;
+		constexpr uint32 SlotReady = 1;
+		constexpr uint32 SlotDone = 2;
+		constexpr uint32 SlotClaimedBase = 16;
+
+		constexpr uint32 MaxAttempts = 2; // Times a genome is handed out before a crash is blamed on the genome itself
+
+		// Spins briefly before yielding and then sleeping, so that idle workers don't burn a core between generations
+		void Backoff(int& IdleRounds)
+		{
+			if (++IdleRounds < 64) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(IdleRounds < 1024 ? 50 : 1000));
+		}
+	}
+
+	struct ProcessEvaluator::SharedHeader
+	{
+		std::atomic<uint32> bShutdown;
+	};
+
+	struct ProcessEvaluator::Slot
+	{
+		std::atomic<uint32> State;
+		uint32 TaskIdx;
+		uint32 Generation;
+		uint32 Size;
+		uint32 Attempts;
+		uint64 ID;
+		uint64 SpeciesID;
+		double Fitness;
+		// Followed by SlotSize bytes of binary genotype
+	};
+
+	ProcessEvaluator::ProcessEvaluator(Trainer* InTrainer, int InNumProcesses, int InSlotSize)
+		: OwningTrainer(InTrainer)
+		, NumProcesses(InNumProcesses > 0 ? InNumProcesses : 1)
+		, SlotSize(InSlotSize > 0 ? InSlotSize : 65536)
+	{
+	}
+
+	ProcessEvaluator::~ProcessEvaluator()
+	{
+		Stop();
+	}
+
+	bool ProcessEvaluator::IsSupported()
+	{
+#ifdef _WIN32
+		return false;
+#else
+		return true;
+#endif
+	}
+
+	ProcessEvaluator::Slot* ProcessEvaluator::GetSlot(int SlotIdx) const
+	{
+		return reinterpret_cast<Slot*>(Mapping + 64 + SlotIdx * SlotStride); // The shared header occupies the first cache line
+	}
+
+#ifndef _WIN32
+	bool ProcessEvaluator::Start()
+	{
+		if (Mapping) return true;
+
+		NumSlots = NumProcesses * 4; // Enough slots that workers rarely wait for the trainer to refill the ring
+		SlotStride = (sizeof(Slot) + SlotSize + 63) & ~size_t(63);
+		MappingSize = 64 + NumSlots * SlotStride;
+
+		void* Memory = mmap(nullptr, MappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (Memory == MAP_FAILED)
+		{
+			LogMessage(LogLevel::Error, "Process evaluation: failed to map " + std::to_string(MappingSize) + " bytes of shared memory");
+			return false;
+		}
+
+		Mapping = static_cast<uint8*>(Memory);
+		new (Mapping) SharedHeader{ { 0 } };
+		for (int SlotIdx = 0; SlotIdx != NumSlots; ++SlotIdx)
+		{
+			new (GetSlot(SlotIdx)) Slot{ { SlotEmpty }, 0, 0, 0, 0, 0, 0, 0.0 };
+		}
+
+		ParentPid = int(getpid());
+		WorkerPids.SetNum(NumProcesses, 0);
+		for (int WorkerIdx = 0; WorkerIdx != NumProcesses; ++WorkerIdx)
+		{
+			if (SpawnWorker(WorkerIdx)) continue;
+			Stop();
+			return false;
+		}
+
+		LogMessage(LogLevel::Info, "Process evaluation: started " + std::to_string(NumProcesses) + " worker processes");
+		return true;
+	}
+
+	void ProcessEvaluator::Stop()
+	{
+		if (!Mapping) return;
+
+		reinterpret_cast<SharedHeader*>(Mapping)->bShutdown.store(1, std::memory_order_release);
+		for (int& Pid : WorkerPids)
+		{
+			if (Pid > 0) waitpid(pid_t(Pid), nullptr, 0);
+			Pid = 0;
+		}
+
+		munmap(Mapping, MappingSize);
+		Mapping = nullptr;
+	}
+
+	bool ProcessEvaluator::SpawnWorker(int WorkerIdx)
+	{
+		fflush(stdout); // Don't let the child inherit half-written log output
+		pid_t Pid = fork();
+		if (Pid < 0)
+		{
+			LogMessage(LogLevel::Error, "Process evaluation: failed to fork a worker process");
+			return false;
+		}
+		if (Pid == 0) RunWorker(WorkerIdx);
+
+		WorkerPids[WorkerIdx] = int(Pid);
+		return true;
+	}
+
+	void ProcessEvaluator::RunWorker(int WorkerIdx)
+	{
+		const ConfigPtr& Config = OwningTrainer->Config;
+		auto* Header = reinterpret_cast<SharedHeader*>(Mapping);
+		const uint32 Claimed = SlotClaimedBase + uint32(WorkerIdx);
+		int IdleRounds = 0;
+
+		while (!Header->bShutdown.load(std::memory_order_acquire) && int(getppid()) == ParentPid)
+		{
+			bool bWorked = false;
+			for (int Offset = 0; Offset != NumSlots; ++Offset)
+			{
+				Slot* CurrentSlot = GetSlot((WorkerIdx + Offset) % NumSlots); // Start scanning at a different slot per worker to spread the contention
+				uint32 Expected = SlotReady;
+				if (!CurrentSlot->State.compare_exchange_strong(Expected, Claimed, std::memory_order_acq_rel)) continue;
+
+				auto Genome = MakeArenaShared<NEAT::Genome>(Config);
+				Genome->ID = CurrentSlot->ID;
+				Genome->SpeciesID = CurrentSlot->SpeciesID;
+				size_t ReadOffset = 0;
+				const uint8* Payload = reinterpret_cast<const uint8*>(CurrentSlot + 1);
+				if (Genome->Genotype.DeserializeBinary(Payload, CurrentSlot->Size, ReadOffset))
+				{
+					Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(CurrentSlot->Generation, Random::Evaluation, CurrentSlot->TaskIdx));
+					CurrentSlot->Fitness = OwningTrainer->Evaluate(Genome);
+				}
+				else
+				{
+					CurrentSlot->Fitness = 0.0;
+				}
+
+				CurrentSlot->State.store(SlotDone, std::memory_order_release);
+				bWorked = true;
+			}
+
+			if (bWorked) IdleRounds = 0;
+			else Backoff(IdleRounds);
+		}
+
+		_exit(0); // Skip destructors and atexit handlers, which belong to the trainer process
+	}
+
+	void ProcessEvaluator::ReapWorkers()
+	{
+		for (int WorkerIdx = 0; WorkerIdx != NumProcesses; ++WorkerIdx)
+		{
+			const pid_t Pid = pid_t(WorkerPids[WorkerIdx]);
+			if (Pid <= 0 || waitpid(Pid, nullptr, WNOHANG) != Pid) continue;
+
+			const uint32 Claimed = SlotClaimedBase + uint32(WorkerIdx);
+			for (int SlotIdx = 0; SlotIdx != NumSlots; ++SlotIdx)
+			{
+				Slot* CurrentSlot = GetSlot(SlotIdx);
+				if (CurrentSlot->State.load(std::memory_order_acquire) != Claimed) continue;
+
+				if (++CurrentSlot->Attempts < MaxAttempts)
+				{
+					CurrentSlot->State.store(SlotReady, std::memory_order_release);
+					continue;
+				}
+
+				LogMessage(LogLevel::Error, "Process evaluation: genome " + std::to_string(CurrentSlot->ID) + " crashed " + std::to_string(MaxAttempts) + " worker processes, assigning it a fitness of zero");
+				CurrentSlot->Fitness = 0.0;
+				CurrentSlot->State.store(SlotDone, std::memory_order_release);
+			}
+
+			LogMessage(LogLevel::Warning, "Process evaluation: worker process " + std::to_string(Pid) + " exited unexpectedly, respawning it");
+			WorkerPids[WorkerIdx] = 0;
+			SpawnWorker(WorkerIdx);
+		}
+	}
+
+	bool ProcessEvaluator::Evaluate(const TArray<GenomePtr>& Genomes, unsigned Generation)
+	{
+		if (!Mapping) return false;
+
+		const int NumTasks = Genomes.Num();
+		int NextTask = 0;
+		int NumInFlight = 0;
+		int IdleRounds = 0;
+		std::vector<uint8> Buffer;
+		TArray<int> Oversized;
+
+		while (NextTask < NumTasks || NumInFlight > 0)
+		{
+			bool bProgress = false;
+			for (int SlotIdx = 0; SlotIdx != NumSlots; ++SlotIdx)
+			{
+				Slot* CurrentSlot = GetSlot(SlotIdx);
+				uint32 State = CurrentSlot->State.load(std::memory_order_acquire);
+				if (State == SlotDone)
+				{
+					Genomes[CurrentSlot->TaskIdx]->Fitness = CurrentSlot->Fitness;
+					CurrentSlot->State.store(SlotEmpty, std::memory_order_release);
+					State = SlotEmpty;
+					NumInFlight--;
+					bProgress = true;
+				}
+				if (State != SlotEmpty) continue;
+
+				// Refill the slot with the next genome that fits into it
+				while (NextTask < NumTasks)
+				{
+					const auto& Genome = Genomes[NextTask];
+					Buffer.clear();
+					Genome->Genotype.SerializeBinary(Buffer);
+					if (Buffer.size() > size_t(SlotSize))
+					{
+						Oversized.Add(NextTask++);
+						continue;
+					}
+
+					CurrentSlot->TaskIdx = uint32(NextTask++);
+					CurrentSlot->Generation = Generation;
+					CurrentSlot->Size = uint32(Buffer.size());
+					CurrentSlot->Attempts = 0;
+					CurrentSlot->ID = Genome->ID;
+					CurrentSlot->SpeciesID = Genome->SpeciesID;
+					std::memcpy(reinterpret_cast<uint8*>(CurrentSlot + 1), Buffer.data(), Buffer.size());
+					CurrentSlot->State.store(SlotReady, std::memory_order_release);
+					NumInFlight++;
+					bProgress = true;
+					break;
+				}
+			}
+
+			ReapWorkers();
+			if (bProgress) IdleRounds = 0;
+			else Backoff(IdleRounds);
+		}
+
+		// Genomes too large for a slot are evaluated here instead
+		for (int TaskIdx : Oversized)
+		{
+			Random::ScopedStream Stream(OwningTrainer->Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, TaskIdx));
+			Genomes[TaskIdx]->Fitness = OwningTrainer->Evaluate(Genomes[TaskIdx]);
+		}
+
+		return true;
+	}
+#else
+	bool ProcessEvaluator::Start() { return false; }
+	void ProcessEvaluator::Stop() { }
+	bool ProcessEvaluator::SpawnWorker(int WorkerIdx) { return false; }
+	void ProcessEvaluator::RunWorker(int WorkerIdx) { }
+	void ProcessEvaluator::ReapWorkers() { }
+	bool ProcessEvaluator::Evaluate(const TArray<GenomePtr>& Genomes, unsigned Generation) { return false; }
+#endif
+} // namespace NEAT
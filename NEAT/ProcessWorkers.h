@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include "Types.h"
+#include "Array.h"
+
+// Multi-process evaluation, for Evaluate implementations that aren't thread-safe (global state, third-party simulators).
+// The trainer forks persistent worker processes that share an anonymous memory mapping with it. Genomes are handed to them through a ring of fixed-size slots in the flat binary genotype encoding, and fitness values come back through the same slots.
+// A worker that crashes is reaped and respawned, and the genome it was evaluating is handed out once more before it is given a fitness of zero.
+// Workers are forked from the trainer, so they see the trainer's state as it was when they were started. Only available on POSIX systems.
+
+namespace NEAT
+{
+	class Genome;
+	using GenomePtr = std::shared_ptr<NEAT::Genome>;
+
+	class Trainer;
+
+	class ProcessEvaluator
+	{
+	public:
+		ProcessEvaluator(Trainer* InTrainer, int InNumProcesses, int InSlotSize);
+		~ProcessEvaluator();
+
+		static bool IsSupported(); // Returns false on platforms without fork and shared anonymous mappings
+
+		bool Start(); // Maps the shared slots and forks the worker processes
+		void Stop(); // Asks the workers to exit, waits for them and unmaps the slots
+		bool Evaluate(const TArray<GenomePtr>& Genomes, unsigned Generation); // Evaluates the genomes on the worker processes, returns false if the workers aren't running
+
+	private:
+		struct SharedHeader;
+		struct Slot;
+
+		Slot* GetSlot(int SlotIdx) const;
+		bool SpawnWorker(int WorkerIdx);
+		void RunWorker(int WorkerIdx); // Worker process main loop, never returns
+		void ReapWorkers(); // Hands the slots of crashed workers out again and respawns them
+
+		Trainer* OwningTrainer = nullptr;
+		int NumProcesses = 0;
+		int SlotSize = 0;
+		int NumSlots = 0;
+		size_t SlotStride = 0;
+		size_t MappingSize = 0;
+		uint8* Mapping = nullptr;
+		TArray<int> WorkerPids;
+		int ParentPid = 0;
+	};
+} // namespace NEAT
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include "Types.h"
+
+// Seedable random number streams for the NEAT algorithm.
+// Every thread owns its own xoshiro256** stream, so random draws never contend on a shared lock and never interleave between threads.
+// Worker threads bind a stream derived from (Seed, StreamID) for the duration of a task, which makes parallel runs reproducible from Config::RandomSeed.
+
+namespace NEAT
+{
+	class RandomStream
+	{
+	public:
+		RandomStream() { Seed(0, 0); }
+		explicit RandomStream(uint64 InSeed, uint64 StreamID = 0) { Seed(InSeed, StreamID); }
+
+		// Seeds the stream from a base seed and a stream index, so that streams sharing a seed but differing in index are statistically independent
+		void Seed(uint64 InSeed, uint64 StreamID = 0)
+		{
+			uint64 Mix = SplitMix64(InSeed) ^ SplitMix64(StreamID + 0x632BE59BD9B4E019ull);
+			for (uint64& Word : State) Word = SplitMix64(Mix);
+		}
+
+		// Returns the next raw 64-bit value (xoshiro256**)
+		uint64 Next()
+		{
+			const uint64 Result = RotateLeft(State[1] * 5, 7) * 9;
+			const uint64 Shifted = State[1] << 17;
+			State[2] ^= State[0];
+			State[3] ^= State[1];
+			State[1] ^= State[2];
+			State[0] ^= State[3];
+			State[2] ^= Shifted;
+			State[3] = RotateLeft(State[3], 45);
+			return Result;
+		}
+
+		// Returns a double uniformly distributed in [0, 1)
+		double NextDouble()
+		{
+			return double(Next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		// Returns a double uniformly distributed in [Min, Max)
+		double NextDouble(double Min, double Max)
+		{
+			return Min + (Max - Min) * NextDouble();
+		}
+
+		// Returns an integer uniformly distributed in [Min, Max]
+		int NextInt(int Min, int Max)
+		{
+			if (Max <= Min) return Min;
+			return Min + int(NextBounded(uint64(int64(Max) - int64(Min)) + 1));
+		}
+
+		// Returns an index uniformly distributed in [0, Num), or 0 when Num is not positive
+		int NextIndex(int Num)
+		{
+			return Num > 0 ? int(NextBounded(uint64(Num))) : 0;
+		}
+
+		bool NextBool()
+		{
+			return (Next() >> 63) != 0;
+		}
+
+	private:
+		uint64 State[4];
+
+		static uint64 RotateLeft(uint64 Value, int Shift)
+		{
+			return (Value << Shift) | (Value >> (64 - Shift));
+		}
+
+		static uint64 SplitMix64(uint64& Value)
+		{
+			uint64 Z = (Value += 0x9E3779B97F4A7C15ull);
+			Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+			return Z ^ (Z >> 31);
+		}
+
+		static uint64 SplitMix64(uint64&& Value)
+		{
+			return SplitMix64(Value);
+		}
+
+		// Multiply-shift reduction of a 64-bit draw into [0, Bound), avoiding the modulo bias of rand() % Bound
+		uint64 NextBounded(uint64 Bound)
+		{
+			const uint64 High = Next() >> 32;
+			return (High * Bound) >> 32;
+		}
+	};
+
+	namespace Random
+	{
+		// The base seed that default (unbound) thread streams are derived from, set by InitializeRandomSeed
+		inline uint64& GetBaseSeed()
+		{
+			static uint64 BaseSeed = 0;
+			return BaseSeed;
+		}
+
+		// The stream owned by the calling thread when no task stream is bound, each thread gets its own stream index in order of first use
+		inline RandomStream& GetThreadStream()
+		{
+			static std::atomic<uint64> NextThreadIndex(0);
+			thread_local RandomStream ThreadStream(GetBaseSeed(), NextThreadIndex.fetch_add(1));
+			return ThreadStream;
+		}
+
+		inline RandomStream*& GetBoundStream()
+		{
+			thread_local RandomStream* BoundStream = nullptr;
+			return BoundStream;
+		}
+
+		// Returns the stream that random draws on the calling thread should use
+		inline RandomStream& GetStream()
+		{
+			RandomStream* Bound = GetBoundStream();
+			return Bound ? *Bound : GetThreadStream();
+		}
+
+		// Combines a generation, phase and worker/task index into a single stream index
+		inline uint64 MakeStreamID(uint64 Generation, uint64 Phase, uint64 Index)
+		{
+			return (Generation << 32) ^ (Phase << 24) ^ Index;
+		}
+
+		// Binds a stream derived from (Seed, StreamID) to the calling thread for the lifetime of the scope, then restores the previous stream
+		class ScopedStream
+		{
+		public:
+			ScopedStream(uint64 Seed, uint64 StreamID) : Stream(Seed, StreamID), PreviousStream(GetBoundStream()) { GetBoundStream() = &Stream; }
+			~ScopedStream() { GetBoundStream() = PreviousStream; }
+
+			ScopedStream(const ScopedStream&) = delete;
+			ScopedStream& operator=(const ScopedStream&) = delete;
+
+		private:
+			RandomStream Stream;
+			RandomStream* PreviousStream = nullptr;
+		};
+
+		// Binds an existing stream to the calling thread for the lifetime of the scope, for tasks that are suspended and resumed with their stream state kept in between
+		class ScopedBinding
+		{
+		public:
+			explicit ScopedBinding(RandomStream& Stream) : PreviousStream(GetBoundStream()) { GetBoundStream() = &Stream; }
+			~ScopedBinding() { GetBoundStream() = PreviousStream; }
+
+			ScopedBinding(const ScopedBinding&) = delete;
+			ScopedBinding& operator=(const ScopedBinding&) = delete;
+
+		private:
+			RandomStream* PreviousStream = nullptr;
+		};
+
+		// Identifiers for the phases that draw random numbers on worker threads, used as the Phase part of MakeStreamID
+		enum EPhase : uint64
+		{
+			Evaluation = 1,
+			SteadyState = 2,
+			Island = 3,
+			Initialization = 4,
+			Pipeline = 5,
+		};
+	}
+} // namespace NEAT
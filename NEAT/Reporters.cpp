@@ -6,25 +6,46 @@
 
 namespace NEAT
 {
+	PopulationReporter::PopulationReporter(Trainer* InTrackedTrainer)
+		: Config(InTrackedTrainer->Config)
+		, Generation(InTrackedTrainer->Generation)
+		, NumGenomes(InTrackedTrainer->Population.Num())
+		, AverageDistance(InTrackedTrainer->AverageDistance)
+		, BestFitness(InTrackedTrainer->BestGenome.Fitness)
+	{
+		Species.Reserve(InTrackedTrainer->Species.Num());
+		for (const SpeciesPtr& Specie : InTrackedTrainer->Species)
+		{
+			SpeciesInfo& Info = Species.AddGetRef();
+			Info.ID = Specie->ID;
+			Info.AdjustedFitness = Specie->AdjustedFitness;
+			Info.Stagnation = Specie->Stagnation;
+			if (Specie->Genomes.IsEmpty()) continue;
+			Info.BestFitness = Specie->GetBestGenome()->Fitness;
+			Info.RepresentativeFitness = Specie->Representative->Fitness;
+			Info.Genomes.Reserve(Specie->Genomes.Num());
+			for (const GenomePtr& Member : Specie->Genomes) Info.Genomes.Add(std::make_shared<Genome>(*Member)); // The genotypes share their genes until either side changes
+		}
+	}
+
 	void PopulationReporter::Report() 
 	{
-		LogMessage(LogLevel::Info, "Population Health Report: Generation " + std::to_string(TrackedTrainer->Generation));
-		LogMessage(LogLevel::Info, "  Number of Species: " + std::to_string(TrackedTrainer->Species.Num()));
-		LogMessage(LogLevel::Info, "  Number of Genomes: " + std::to_string(TrackedTrainer->Population.Num()));
-		LogMessage(LogLevel::Info, "  Average Genome Distance: " + std::to_string(TrackedTrainer->AverageDistance));
-		LogMessage(LogLevel::Info, "  Best Fitness: " + std::to_string(TrackedTrainer->BestGenome.Fitness));
+		LogMessage(LogLevel::Info, "Population Health Report: Generation " + std::to_string(Generation));
+		LogMessage(LogLevel::Info, "  Number of Species: " + std::to_string(Species.Num()));
+		LogMessage(LogLevel::Info, "  Number of Genomes: " + std::to_string(NumGenomes));
+		LogMessage(LogLevel::Info, "  Average Genome Distance: " + std::to_string(AverageDistance));
+		LogMessage(LogLevel::Info, "  Best Fitness: " + std::to_string(BestFitness));
 
-		for (const SpeciesPtr& Specie : TrackedTrainer->Species) 
+		for (const SpeciesInfo& Specie : Species) 
 		{
-			if (Specie->Genomes.IsEmpty()) continue;
-			auto BestGenome = Specie->GetBestGenome();
-			LogMessage(LogLevel::Info, "  Species " + std::to_string(Specie->ID) + ":");
-			LogMessage(LogLevel::Info, "   Number of Genomes: " + std::to_string(Specie->Genomes.Num()));
-			LogMessage(LogLevel::Info, "   Best Fitness: " + std::to_string(BestGenome ? BestGenome->Fitness : 0));
-			LogMessage(LogLevel::Info, "   Adjusted Fitness: " + std::to_string(Specie->AdjustedFitness));
-			LogMessage(LogLevel::Info, "   Representative Fitness: " + std::to_string(Specie->Representative->Fitness));
-			LogMessage(LogLevel::Info, "   Average Genome Distance: " + std::to_string(Specie->GetAverageGenomeDistance()));
-			LogMessage(LogLevel::Info, "   Stagnation: " + std::to_string(Specie->Stagnation));
+			if (Specie.Genomes.IsEmpty()) continue;
+			LogMessage(LogLevel::Info, "  Species " + std::to_string(Specie.ID) + ":");
+			LogMessage(LogLevel::Info, "   Number of Genomes: " + std::to_string(Specie.Genomes.Num()));
+			LogMessage(LogLevel::Info, "   Best Fitness: " + std::to_string(Specie.BestFitness));
+			LogMessage(LogLevel::Info, "   Adjusted Fitness: " + std::to_string(Specie.AdjustedFitness));
+			LogMessage(LogLevel::Info, "   Representative Fitness: " + std::to_string(Specie.RepresentativeFitness));
+			LogMessage(LogLevel::Info, "   Average Genome Distance: " + std::to_string(NEAT::Species::GetAverageGenomeDistance(Specie.Genomes, Config)));
+			LogMessage(LogLevel::Info, "   Stagnation: " + std::to_string(Specie.Stagnation));
 		}
 
 		/*for (const GenomePtr& Genome : TrackedTrainer->Population)
@@ -10,12 +10,28 @@ namespace NEAT
 		virtual void Report() = 0;
 	};
 
+	// Copies what it reports when constructed, so that Report can run on a background task while the trainer moves on to the next generation
 	class PopulationReporter : public Reporter 
 	{
-		const Trainer* TrackedTrainer = nullptr;
+		struct SpeciesInfo
+		{
+			uint64 ID = 0;
+			double BestFitness = 0.0;
+			double AdjustedFitness = 0.0;
+			double RepresentativeFitness = 0.0;
+			unsigned Stagnation = 0;
+			TArray<GenomePtr> Genomes; // Copies of the species members, the average distance between them is the costly part of the report
+		};
+
+		ConfigPtr Config = nullptr;
+		uint64 Generation = 0;
+		int NumGenomes = 0;
+		double AverageDistance = 0.0;
+		double BestFitness = 0.0;
+		TArray<SpeciesInfo> Species;
 
 	public:
-		PopulationReporter(Trainer* InTrackedTrainer) : TrackedTrainer(InTrackedTrainer) {}
+		PopulationReporter(Trainer* InTrackedTrainer);
 		void Report() override;
 	};
 
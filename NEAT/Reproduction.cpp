@@ -22,27 +22,39 @@ std::string ToString(EInitialTopology Topology)
 }
 
 GenomePtr InitializeFromParents(const GenomePtr& Parent1, const GenomePtr& Parent2) // Initialize a genome from two parents
+{
+	return InitializeFromParents(Parent1, Parent2, NEAT::Genome::GenerateNewGenomeID());
+}
+
+GenomePtr InitializeFromParents(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID) // Initialize a genome from two parents, with an ID reserved by the caller
 {
 	const auto Config = Parent1->Config;
-	GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-	Genome->SpeciesID = GetRandomInt(0, 1) ? Parent1->SpeciesID : Parent2->SpeciesID;
-	Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+	const uint64 SpeciesID = GetRandomInt(0, 1) ? Parent1->SpeciesID : Parent2->SpeciesID;
 
+	GenomePtr Child = nullptr;
 	switch (Config->CrossoverType)
 	{
-	case ECrossoverType::Uniform: return CrossoverType::Uniform(Parent1, Parent2);
-	case ECrossoverType::SinglePoint: return CrossoverType::SinglePoint(Parent1, Parent2);
-	case ECrossoverType::TwoPoint: return CrossoverType::TwoPoint(Parent1, Parent2);
-	case ECrossoverType::Multipoint: return CrossoverType::Multipoint(Parent1, Parent2);
-	default: return CrossoverType::Uniform(Parent1, Parent2);
+	case ECrossoverType::Uniform: Child = CrossoverType::Uniform(Parent1, Parent2, ID); break;
+	case ECrossoverType::SinglePoint: Child = CrossoverType::SinglePoint(Parent1, Parent2, ID); break;
+	case ECrossoverType::TwoPoint: Child = CrossoverType::TwoPoint(Parent1, Parent2, ID); break;
+	case ECrossoverType::Multipoint: Child = CrossoverType::Multipoint(Parent1, Parent2, ID); break;
+	default: Child = CrossoverType::Uniform(Parent1, Parent2, ID); break;
 	}
-	return nullptr;
+	if (!Child) return nullptr;
+	Child->SpeciesID = SpeciesID;
+	Child->Genotype.RefreshIndexes(); // Crossover assembles the genes wholesale, so the hashes are computed once here
+	return Child;
 }
 
 GenomePtr InitializeFromParent(const GenomePtr& Parent) // Initialize a genome from a single parent
 {
-	GenomePtr Genome = std::make_shared<NEAT::Genome>(Parent->Config);
-	Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+	return InitializeFromParent(Parent, NEAT::Genome::GenerateNewGenomeID());
+}
+
+GenomePtr InitializeFromParent(const GenomePtr& Parent, uint64 ID) // Initialize a genome from a single parent, with an ID reserved by the caller
+{
+	GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Parent->Config);
+	Genome->ID = ID;
 	Genome->SpeciesID = Parent->SpeciesID;
 	Genome->Genotype = Parent->Genotype;
 	return std::move(Genome);
@@ -50,8 +62,13 @@ GenomePtr InitializeFromParent(const GenomePtr& Parent) // Initialize a genome f
 
 GenomePtr InitializeGenome(const ConfigPtr& Config) // Initialize a single genome from Config defaults
 {
-	GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-	Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+	return InitializeGenome(Config, NEAT::Genome::GenerateNewGenomeID());
+}
+
+GenomePtr InitializeGenome(const ConfigPtr& Config, uint64 ID) // Initialize a single genome from Config defaults, with an ID reserved by the caller
+{
+	GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Config);
+	Genome->ID = ID;
 
 	switch (Config->InitialTopology)
 	{
@@ -62,9 +79,45 @@ GenomePtr InitializeGenome(const ConfigPtr& Config) // Initialize a single genom
 	default: InitialTopology::None(Genome); break;
 	}
 
+	Genome->Genotype.RefreshIndexes();
 	return std::move(Genome);
 }
 
+void RegisterInnovations(const ConfigPtr& Config) // Number the initial topology connections in the same order Full creates them, and keep them as the template initial genomes are built from
+{
+	auto& Tracker = GetInnovations();
+	Tracker.InitialConnections.Reset();
+	if (Config->InitialTopology == EInitialTopology::None) return;
+
+	const uint64 NumInputs = Config->NumInputs + 1; // +1 for the bias node
+	const uint64 FirstOutput = NumInputs;
+	const uint64 FirstHidden = NumInputs + Config->NumOutputs;
+	auto Register = [&Tracker](uint64 InputID, uint64 OutputID)
+	{
+		const uint64 ID = Tracker.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputID, OutputID);
+		Tracker.InitialConnections.Add(Innovation{ ID, EMutationType::AddConnection, EGeneType::Connection, InputID, OutputID });
+	};
+
+	Tracker.InitialConnections.Reserve(int(NumInputs * (Config->NumHidden + Config->NumOutputs) + uint64(Config->NumHidden) * Config->NumOutputs));
+	for (uint64 InputID = 0; InputID != NumInputs; ++InputID)
+	{
+		for (int Jdx = 0; Jdx != Config->NumHidden; ++Jdx) Register(InputID, FirstHidden + Jdx);
+		for (int Jdx = 0; Jdx != Config->NumOutputs; ++Jdx) Register(InputID, FirstOutput + Jdx);
+	}
+	for (int Idx = 0; Idx != Config->NumHidden; ++Idx)
+	{
+		for (int Jdx = 0; Jdx != Config->NumOutputs; ++Jdx) Register(FirstHidden + Idx, FirstOutput + Jdx);
+	}
+}
+
+const TArray<Innovation>& GetInitialConnections(const ConfigPtr& Config) // The template of the tracker bound to the calling thread, numbered on first use if the trainer didn't register it
+{
+	auto& Tracker = GetInnovations();
+	if (Tracker.Base) return Tracker.Base->InitialConnections; // Provisional trackers build from the template of the tracker they extend
+	if (Tracker.InitialConnections.IsEmpty()) RegisterInnovations(Config);
+	return Tracker.InitialConnections;
+}
+
 void None(GenomePtr Genome) // Initialize connections for an initially unconnected neural network
 {
 	auto& Connections = Genome->Genotype.Connections;
@@ -90,41 +143,11 @@ void Sparse(GenomePtr Genome) // Initialize connections for a sparsely connected
 {
 	None(Genome); // Start with an unconnected network
 	auto& Connections = Genome->Genotype.Connections;
-	auto& Nodes = Genome->Genotype.Nodes;
 	const auto Config = Genome->Config;
-	// Connect each input node to each hidden node 
-	for (int Idx = 0, StopIdx = (Config->NumInputs + 1); Idx != StopIdx; ++Idx) // +1 for the bias node
+	for (const auto& Initial : GetInitialConnections(Config)) // The template lists input to hidden, input to output, then hidden to output connections, the order the draws were always made in
 	{
-		auto InputNode = Genome->GetNodeByID(Idx); // Get the input node
-		for (int Jdx = 0, StopJdx = Config->NumHidden; Jdx != StopJdx; ++Jdx)
-		{
-			if (GetRandomDouble(0.0, 1.0) >= Config->InitialConnectionProbability) continue; // Connect each input node to each output node with a probability of InitialConnectionProbability
-			auto HiddenNode = Genome->GetNodeByID(Jdx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputNode->ID, HiddenNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, InputNode->ID, HiddenNode->ID, 1.0); // Create a new connection
-		}
-		for (int Jdx = 0, StopJdx = Config->NumOutputs; Jdx != StopJdx; ++Jdx)
-		{
-			if (GetRandomDouble(0.0, 1.0) >= Config->InitialConnectionProbability) continue; // Connect each input node to each output node with a probability of InitialConnectionProbability
-			auto OutputNode = Genome->GetNodeByID(Jdx + Config->NumInputs + 1); // Get the output node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputNode->ID, OutputNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, InputNode->ID, OutputNode->ID, 1.0); // Create a new connection
-		}
-	}
-	// Connect each hidden node to each output node 
-	for (int Idx = 0, StopIdx = Config->NumHidden; Idx != StopIdx; ++Idx)
-	{
-		auto HiddenNode = Genome->GetNodeByID(Idx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node, +1 for the bias node
-		for (int Jdx = 0, StopJdx = Config->NumOutputs; Jdx != StopJdx; ++Jdx)
-		{
-			if (GetRandomDouble(0.0, 1.0) >= Config->InitialConnectionProbability) continue; // Connect each input node to each output node with a probability of InitialConnectionProbability
-			auto OutputNode = Genome->GetNodeByID(Jdx + Config->NumInputs + 1); // Get the output node, +1 for the bias node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, HiddenNode->ID, OutputNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, HiddenNode->ID, OutputNode->ID, 1.0); // Create a new connection
-		}
+		if (GetRandomDouble(0.0, 1.0) >= Config->InitialConnectionProbability) continue; // Keep each connection with a probability of InitialConnectionProbability
+		Connections[Initial.ID] = ConnectionGene(Initial.ID, Initial.Input, Initial.Output, 1.0);
 	}
 }
 
@@ -132,38 +155,10 @@ void Full(GenomePtr Genome) // Initialize connections from every Input to every
 {
 	None(Genome); // Start with an unconnected network
 	auto& Connections = Genome->Genotype.Connections;
-	auto& Nodes = Genome->Genotype.Nodes;
 	const auto Config = Genome->Config;
-	// Connect each input node to each hidden node 
-	for (int Idx = 0, StopIdx = (Config->NumInputs + 1); Idx != StopIdx; ++Idx) // +1 for the bias node
-	{
-		auto InputNode = Genome->GetNodeByID(Idx); // Get the input node
-		for (int Jdx = 0, StopJdx = Config->NumHidden; Jdx != StopJdx; ++Jdx)
-		{
-			auto HiddenNode = Genome->GetNodeByID(Jdx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputNode->ID, HiddenNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, InputNode->ID, HiddenNode->ID, 1.0); // Create a new connection
-		}
-		for (int Jdx = 0, StopJdx = Config->NumOutputs; Jdx != StopJdx; ++Jdx)
-		{
-			auto OutputNode = Genome->GetNodeByID(Jdx + Config->NumInputs + 1); // Get the output node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputNode->ID, OutputNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, InputNode->ID, OutputNode->ID, 1.0); // Create a new connection
-		}
-	}
-	// Connect each hidden node to each output node 
-	for (int Idx = 0, StopIdx = Config->NumHidden; Idx != StopIdx; ++Idx)
+	for (const auto& Initial : GetInitialConnections(Config))
 	{
-		auto HiddenNode = Genome->GetNodeByID(Idx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node, +1 for the bias node
-		for (int Jdx = 0, StopJdx = Config->NumOutputs; Jdx != StopJdx; ++Jdx)
-		{
-			auto OutputNode = Genome->GetNodeByID(Jdx + Config->NumInputs + 1); // Get the output node, +1 for the bias node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, HiddenNode->ID, OutputNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, HiddenNode->ID, OutputNode->ID, 1.0); // Create a new connection
-		}
+		Connections[Initial.ID] = ConnectionGene(Initial.ID, Initial.Input, Initial.Output, 1.0);
 	}
 }
 
@@ -171,46 +166,29 @@ void Tree(GenomePtr Genome) // Initialize connections for a tree-like neural net
 {
 	None(Genome); // Start with an unconnected network
 	auto& Connections = Genome->Genotype.Connections;
-	auto& Nodes = Genome->Genotype.Nodes;
 	const auto Config = Genome->Config;
-	// Connect each input node to each hidden node 
-	for (int Idx = 0, StopIdx = (Config->NumInputs + 1); Idx != StopIdx; ++Idx) // +1 for the bias node
-	{
-		auto InputNode = Genome->GetNodeByID(Idx); // Get the input node
-		for (int Jdx = 0, StopJdx = Config->NumHidden; Jdx != StopJdx; ++Jdx)
-		{
-			auto HiddenNode = Genome->GetNodeByID(Jdx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, InputNode->ID, HiddenNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, InputNode->ID, HiddenNode->ID, 1.0); // Create a new connection
-		}
-	}
-	// Connect each hidden node to each output node 
-	for (int Idx = 0, StopIdx = Config->NumHidden; Idx != StopIdx; ++Idx)
+	const uint64 FirstHidden = Config->NumInputs + Config->NumOutputs + 1; // +1 for the bias node
+	for (const auto& Initial : GetInitialConnections(Config))
 	{
-		for (int Jdx = 0, StopJdx = Config->NumOutputs; Jdx != StopJdx; ++Jdx)
-		{
-			auto HiddenNode = Genome->GetNodeByID(Idx + Config->NumInputs + Config->NumOutputs + 1); // Get the hidden node, +1 for the bias node
-			auto OutputNode = Genome->GetNodeByID(Jdx + Config->NumInputs + 1); // Get the output node, +1 for the bias node
-			auto ConnectionID = Innovations.GetInnovationID(EMutationType::AddConnection, EGeneType::Connection, HiddenNode->ID, OutputNode->ID); // Get the new connection ID
-			if (Connections.Contains(ConnectionID)) continue; // Connection already exists
-			Connections[ConnectionID] = ConnectionGene(ConnectionID, HiddenNode->ID, OutputNode->ID, 1.0); // Create a new connection
-		}
+		if (Initial.Input < FirstHidden && Initial.Output < FirstHidden) continue; // Inputs only connect to hidden nodes
+		Connections[Initial.ID] = ConnectionGene(Initial.ID, Initial.Input, Initial.Output, 1.0);
 	}
 }
 
 } // namespace InitialTopology
 
 namespace CrossoverType {
-	GenomePtr Uniform(const GenomePtr& Parent1, const GenomePtr& Parent2) // Initialize a genome from two parents using uniform crossover
+	GenomePtr Uniform(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID) // Initialize a genome from two parents using uniform crossover
 	{
 		const auto Config = Parent1->Config;
-		GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-		Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+		const NEAT::Genotype& Genes1 = Parent1->Genotype; // Parents are only read, and other threads may breed from them at the same time
+		const NEAT::Genotype& Genes2 = Parent2->Genotype;
+		GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Config);
+		Genome->ID = ID;
 
 		// Iterate over the node genes of both parents  
-		const auto& NodeKeys1 = Parent1->Genotype.Nodes.GetKeys();
-		const auto& NodeKeys2 = Parent2->Genotype.Nodes.GetKeys();
+		const auto& NodeKeys1 = Genes1.Nodes.GetKeys();
+		const auto& NodeKeys2 = Genes2.Nodes.GetKeys();
 		TArray<uint64> CombinedNodeKeys;
 		for (const auto& Key : NodeKeys1) CombinedNodeKeys.AddUnique(Key);
 		for (const auto& Key : NodeKeys2) CombinedNodeKeys.AddUnique(Key);
@@ -218,30 +196,30 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedNodeKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 NodeKey = CombinedNodeKeys[Idx];
-			if (Parent1->Genotype.Nodes.Contains(NodeKey) && Parent2->Genotype.Nodes.Contains(NodeKey))
+			if (Genes1.Nodes.Contains(NodeKey) && Genes2.Nodes.Contains(NodeKey))
 			{
 				if (GetRandomDouble(0.0, 1.0) < 0.5)
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 				}
 				else
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 				}
 			}
-			else if (Parent1->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes1.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 			}
-			else if (Parent2->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes2.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 			}
 		}
 
 		// Iterate over the connection genes of both parents
-		const auto& ConnectionKeys1 = Parent1->Genotype.Connections.GetKeys();
-		const auto& ConnectionKeys2 = Parent2->Genotype.Connections.GetKeys();
+		const auto& ConnectionKeys1 = Genes1.Connections.GetKeys();
+		const auto& ConnectionKeys2 = Genes2.Connections.GetKeys();
 		TArray<uint64> CombinedConnectionKeys;
 		for (const auto& Key : ConnectionKeys1) CombinedConnectionKeys.AddUnique(Key);
 		for (const auto& Key : ConnectionKeys2) CombinedConnectionKeys.AddUnique(Key);
@@ -249,35 +227,37 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedConnectionKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 ConnectionKey = CombinedConnectionKeys[Idx];
-			if (Parent1->Genotype.Connections.Contains(ConnectionKey) && Parent2->Genotype.Connections.Contains(ConnectionKey))
+			if (Genes1.Connections.Contains(ConnectionKey) && Genes2.Connections.Contains(ConnectionKey))
 			{
 				if (GetRandomDouble(0.0, 1.0) < 0.5)
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 				}
 				else
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 				}
 			}
-			else if (Parent1->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes1.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 			}
-			else if (Parent2->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes2.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 			}
 		}
 
 		return std::move(Genome);
 	}
 
-	GenomePtr Multipoint(const GenomePtr& Parent1, const GenomePtr& Parent2) // Initialize a genome from two parents using multipoint crossover with settings from Config->CrossoverPoints  
+	GenomePtr Multipoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID) // Initialize a genome from two parents using multipoint crossover with settings from Config->CrossoverPoints  
 	{
 		const auto Config = Parent1->Config;
-		GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-		Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+		const NEAT::Genotype& Genes1 = Parent1->Genotype;
+		const NEAT::Genotype& Genes2 = Parent2->Genotype;
+		GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Config);
+		Genome->ID = ID;
 
 		int NumCrossoverPoints = Config->CrossoverPoints;
 		TArray<int> CrossoverPoints;
@@ -288,8 +268,8 @@ namespace CrossoverType {
 		CrossoverPoints.Sort();
 
 		// Iterate over the node genes of both parents
-		const auto& NodeKeys1 = Parent1->Genotype.Nodes.GetKeys();
-		const auto& NodeKeys2 = Parent2->Genotype.Nodes.GetKeys();
+		const auto& NodeKeys1 = Genes1.Nodes.GetKeys();
+		const auto& NodeKeys2 = Genes2.Nodes.GetKeys();
 		TArray<uint64> CombinedNodeKeys;
 		for (const auto& Key : NodeKeys1) CombinedNodeKeys.AddUnique(Key);
 		for (const auto& Key : NodeKeys2) CombinedNodeKeys.AddUnique(Key);
@@ -297,7 +277,7 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedNodeKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 NodeKey = CombinedNodeKeys[Idx];
-			if (Parent1->Genotype.Nodes.Contains(NodeKey) && Parent2->Genotype.Nodes.Contains(NodeKey))
+			if (Genes1.Nodes.Contains(NodeKey) && Genes2.Nodes.Contains(NodeKey))
 			{
 				bool bUseParent1 = true;
 				for (int Jdx = 0, StopJdx = CrossoverPoints.Num(); Jdx != StopJdx; ++Jdx)
@@ -310,26 +290,26 @@ namespace CrossoverType {
 				}
 				if (bUseParent1)
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 				}
 				else
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 				}
 			}
-			else if (Parent1->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes1.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 			}
-			else if (Parent2->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes2.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 			}
 		}
 
 		// Iterate over the connection genes of both parents
-		const auto& ConnectionKeys1 = Parent1->Genotype.Connections.GetKeys();
-		const auto& ConnectionKeys2 = Parent2->Genotype.Connections.GetKeys();
+		const auto& ConnectionKeys1 = Genes1.Connections.GetKeys();
+		const auto& ConnectionKeys2 = Genes2.Connections.GetKeys();
 		TArray<uint64> CombinedConnectionKeys;
 		for (const auto& Key : ConnectionKeys1) CombinedConnectionKeys.AddUnique(Key);
 		for (const auto& Key : ConnectionKeys2) CombinedConnectionKeys.AddUnique(Key);
@@ -339,7 +319,7 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedConnectionKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 ConnectionKey = CombinedConnectionKeys[Idx];
-			if (Parent1->Genotype.Connections.Contains(ConnectionKey) && Parent2->Genotype.Connections.Contains(ConnectionKey)) // If present in both parents
+			if (Genes1.Connections.Contains(ConnectionKey) && Genes2.Connections.Contains(ConnectionKey)) // If present in both parents
 			{
 				bool bUseParent1 = true;
 				for (int Jdx = 0, StopJdx = CrossoverPoints.Num(); Jdx != StopJdx; ++Jdx)
@@ -351,33 +331,35 @@ namespace CrossoverType {
 					}
 				}
 
-				if (bUseParent1) Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey]; // Copy from Parent1
-				else Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey]; // Copy from Parent2
+				if (bUseParent1) Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey]; // Copy from Parent1
+				else Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey]; // Copy from Parent2
 			}
-			else if (Parent1->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes1.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 			}
-			else if (Parent2->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes2.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 			}
 		}
 
 		return std::move(Genome);
 	}
 
-	GenomePtr SinglePoint(const GenomePtr& Parent1, const GenomePtr& Parent2) // Initialize a genome from two parents using single-point crossover
+	GenomePtr SinglePoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID) // Initialize a genome from two parents using single-point crossover
 	{
 		const auto Config = Parent1->Config;
-		GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-		Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+		const NEAT::Genotype& Genes1 = Parent1->Genotype;
+		const NEAT::Genotype& Genes2 = Parent2->Genotype;
+		GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Config);
+		Genome->ID = ID;
 
 		int CrossoverPoint = GetRandomInt(0, std::min(Parent1->GetNumNodes(), Parent2->GetNumNodes()) - 1);
 
 		// Iterate over the node genes of both parents
-		const auto& NodeKeys1 = Parent1->Genotype.Nodes.GetKeys();
-		const auto& NodeKeys2 = Parent2->Genotype.Nodes.GetKeys();
+		const auto& NodeKeys1 = Genes1.Nodes.GetKeys();
+		const auto& NodeKeys2 = Genes2.Nodes.GetKeys();
 		TArray<uint64> CombinedNodeKeys;
 		for (const auto& Key : NodeKeys1) CombinedNodeKeys.AddUnique(Key);
 		for (const auto& Key : NodeKeys2) CombinedNodeKeys.AddUnique(Key);
@@ -387,30 +369,30 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedNodeKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 NodeKey = CombinedNodeKeys[Idx];
-			if (Parent1->Genotype.Nodes.Contains(NodeKey) && Parent2->Genotype.Nodes.Contains(NodeKey))
+			if (Genes1.Nodes.Contains(NodeKey) && Genes2.Nodes.Contains(NodeKey))
 			{
 				if (NodeKey < CrossoverPoint)
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 				}
 				else
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 				}
 			}
-			else if (Parent1->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes1.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 			}
-			else if (Parent2->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes2.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 			}
 		}
 
 		// Iterate over the connection genes of both parents
-		const auto& ConnectionKeys1 = Parent1->Genotype.Connections.GetKeys();
-		const auto& ConnectionKeys2 = Parent2->Genotype.Connections.GetKeys();
+		const auto& ConnectionKeys1 = Genes1.Connections.GetKeys();
+		const auto& ConnectionKeys2 = Genes2.Connections.GetKeys();
 		TArray<uint64> CombinedConnectionKeys;
 		for (const auto& Key : ConnectionKeys1) CombinedConnectionKeys.AddUnique(Key);
 		for (const auto& Key : ConnectionKeys2) CombinedConnectionKeys.AddUnique(Key);
@@ -420,24 +402,24 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedConnectionKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 ConnectionKey = CombinedConnectionKeys[Idx];
-			if (Parent1->Genotype.Connections.Contains(ConnectionKey) && Parent2->Genotype.Connections.Contains(ConnectionKey))
+			if (Genes1.Connections.Contains(ConnectionKey) && Genes2.Connections.Contains(ConnectionKey))
 			{
 				if (ConnectionKey < CrossoverPoint)
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 				}
 				else
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 				}
 			}
-			else if (Parent1->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes1.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 			}
-			else if (Parent2->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes2.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 			}
 		}
 
@@ -445,18 +427,20 @@ namespace CrossoverType {
 		return std::move(Genome);
 	}
 
-	GenomePtr TwoPoint(const GenomePtr& Parent1, const GenomePtr& Parent2) // Initialize a genome from two parents using two-point crossover  
+	GenomePtr TwoPoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID) // Initialize a genome from two parents using two-point crossover  
 	{
 		const auto Config = Parent1->Config;
-		GenomePtr Genome = std::make_shared<NEAT::Genome>(Config);
-		Genome->ID = NEAT::Genome::GenerateNewGenomeID();
+		const NEAT::Genotype& Genes1 = Parent1->Genotype;
+		const NEAT::Genotype& Genes2 = Parent2->Genotype;
+		GenomePtr Genome = MakeArenaShared<NEAT::Genome>(Config);
+		Genome->ID = ID;
 
 		int CrossoverPoint1 = GetRandomInt(0, std::min(Parent1->GetNumNodes(), Parent2->GetNumNodes()) - 1);
 		int CrossoverPoint2 = GetRandomInt(0, std::min(Parent1->GetNumNodes(), Parent2->GetNumNodes()) - 1);
 
 		// Iterate over the node genes of both parents
-		const auto& NodeKeys1 = Parent1->Genotype.Nodes.GetKeys();
-		const auto& NodeKeys2 = Parent2->Genotype.Nodes.GetKeys();
+		const auto& NodeKeys1 = Genes1.Nodes.GetKeys();
+		const auto& NodeKeys2 = Genes2.Nodes.GetKeys();
 		TArray<uint64> CombinedNodeKeys;
 		for (const auto& Key : NodeKeys1) CombinedNodeKeys.AddUnique(Key);
 		for (const auto& Key : NodeKeys2) CombinedNodeKeys.AddUnique(Key);
@@ -467,34 +451,34 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedNodeKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 NodeKey = CombinedNodeKeys[Idx];
-			if (Parent1->Genotype.Nodes.Contains(NodeKey) && Parent2->Genotype.Nodes.Contains(NodeKey))
+			if (Genes1.Nodes.Contains(NodeKey) && Genes2.Nodes.Contains(NodeKey))
 			{
 				if (NodeKey < CrossoverPoint1)
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 				}
 				else if (NodeKey < CrossoverPoint2)
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 				}
 				else
 				{
-					Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+					Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 				}
 			}
-			else if (Parent1->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes1.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent1->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes1.Nodes[NodeKey];
 			}
-			else if (Parent2->Genotype.Nodes.Contains(NodeKey))
+			else if (Genes2.Nodes.Contains(NodeKey))
 			{
-				Genome->Genotype.Nodes[NodeKey] = Parent2->Genotype.Nodes[NodeKey];
+				Genome->Genotype.Nodes[NodeKey] = Genes2.Nodes[NodeKey];
 			}
 		}
 
 		// Iterate over the connection genes of both parents
-		const auto& ConnectionKeys1 = Parent1->Genotype.Connections.GetKeys();
-		const auto& ConnectionKeys2 = Parent2->Genotype.Connections.GetKeys();
+		const auto& ConnectionKeys1 = Genes1.Connections.GetKeys();
+		const auto& ConnectionKeys2 = Genes2.Connections.GetKeys();
 		TArray<uint64> CombinedConnectionKeys;
 		for (const auto& Key : ConnectionKeys1) CombinedConnectionKeys.AddUnique(Key);
 		for (const auto& Key : ConnectionKeys2) CombinedConnectionKeys.AddUnique(Key);
@@ -505,28 +489,28 @@ namespace CrossoverType {
 		for (int Idx = 0, StopIdx = CombinedConnectionKeys.Num(); Idx != StopIdx; ++Idx)
 		{
 			uint64 ConnectionKey = CombinedConnectionKeys[Idx];
-			if (Parent1->Genotype.Connections.Contains(ConnectionKey) && Parent2->Genotype.Connections.Contains(ConnectionKey))
+			if (Genes1.Connections.Contains(ConnectionKey) && Genes2.Connections.Contains(ConnectionKey))
 			{
 				if (ConnectionKey < CrossoverPoint1)
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 				}
 				else if (ConnectionKey < CrossoverPoint2)
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 				}
 				else
 				{
-					Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+					Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 				}
 			}
-			else if (Parent1->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes1.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent1->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes1.Connections[ConnectionKey];
 			}
-			else if (Parent2->Genotype.Connections.Contains(ConnectionKey))
+			else if (Genes2.Connections.Contains(ConnectionKey))
 			{
-				Genome->Genotype.Connections[ConnectionKey] = Parent2->Genotype.Connections[ConnectionKey];
+				Genome->Genotype.Connections[ConnectionKey] = Genes2.Connections[ConnectionKey];
 			}
 		}
 
@@ -537,9 +521,14 @@ namespace CrossoverType {
 namespace GenomePairing {
 GenomePtr Offspring::GetChild() const
 {
-	if (Parent1 && Parent2) return InitialTopology::InitializeFromParents(Parent1, Parent2);
-	else if (Parent1) return InitialTopology::InitializeFromParent(Parent1);
-	else return InitialTopology::InitializeGenome(Config);
+	return GetChild(NEAT::Genome::GenerateNewGenomeID());
+}
+
+GenomePtr Offspring::GetChild(uint64 ID) const
+{
+	if (Parent1 && Parent2) return InitialTopology::InitializeFromParents(Parent1, Parent2, ID);
+	else if (Parent1) return InitialTopology::InitializeFromParent(Parent1, ID);
+	else return InitialTopology::InitializeGenome(Config, ID);
 }
 
 TArray<Offspring> Random(const TArray<GenomePtr>& Population, int ReproductionCount, const ConfigPtr& Config)
@@ -548,9 +537,9 @@ TArray<Offspring> Random(const TArray<GenomePtr>& Population, int ReproductionCo
 	int NumOffspring = int(Config->PopulationSize - Population.Num());
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		bool bCrossover = (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate);
-		if (bCrossover) OffspringList.Add(Offspring(Config, Population[rand() % Population.Num()], Population[rand() % Population.Num()]));
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, Population[rand() % Population.Num()])); // 50/50 chance of asexual reproduction with mutation 
+		bool bCrossover = (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate);
+		if (bCrossover) OffspringList.Add(Offspring(Config, Population[GetRandomIndex(Population.Num())], Population[GetRandomIndex(Population.Num())]));
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, Population[GetRandomIndex(Population.Num())])); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -571,9 +560,9 @@ TArray<Offspring> Fittest(const TArray<GenomePtr>& Population, int ReproductionC
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		bool bCrossover = (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate);
-		if (bCrossover) OffspringList.Add(Offspring(Config, FittestGenome, Population[rand() % Population.Num()]));
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, FittestGenome)); // 50/50 chance of asexual reproduction with mutation 
+		bool bCrossover = (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate);
+		if (bCrossover) OffspringList.Add(Offspring(Config, FittestGenome, Population[GetRandomIndex(Population.Num())]));
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, FittestGenome)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -594,9 +583,9 @@ TArray<Offspring> Weakest(const TArray<GenomePtr>& Population, int ReproductionC
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		bool bCrossover = (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate);
-		if (bCrossover) OffspringList.Add(Offspring(Config, WeakestGenome, Population[rand() % Population.Num()]));
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, WeakestGenome)); // 50/50 chance of asexual reproduction with mutation 
+		bool bCrossover = (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate);
+		if (bCrossover) OffspringList.Add(Offspring(Config, WeakestGenome, Population[GetRandomIndex(Population.Num())]));
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, WeakestGenome)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -623,17 +612,17 @@ TArray<Offspring> Alternating(const TArray<GenomePtr>& Population, int Reproduct
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		bool bCrossover = (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate);
+		bool bCrossover = (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate);
 		if (Idx % 2 == 0) // Even index  
 		{
-			if (bCrossover) OffspringList.Add(Offspring(Config, FittestGenome, Population[rand() % Population.Num()]));
-			else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, FittestGenome)); // 50/50 chance of asexual reproduction with mutation 
+			if (bCrossover) OffspringList.Add(Offspring(Config, FittestGenome, Population[GetRandomIndex(Population.Num())]));
+			else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, FittestGenome)); // 50/50 chance of asexual reproduction with mutation 
 			else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 		}
 		else // Odd index  
 		{
-			if (bCrossover) OffspringList.Add(Offspring(Config, WeakestGenome, Population[rand() % Population.Num()]));
-			else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, WeakestGenome)); // 50/50 chance of asexual reproduction with mutation 
+			if (bCrossover) OffspringList.Add(Offspring(Config, WeakestGenome, Population[GetRandomIndex(Population.Num())]));
+			else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, WeakestGenome)); // 50/50 chance of asexual reproduction with mutation 
 			else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 		}
 	}
@@ -646,11 +635,11 @@ TArray<Offspring> SimilarFitness(const TArray<GenomePtr>& Population, int Reprod
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		int Parent1Idx = rand() % Population.Num(); // Select Parent1 at random  
+		int Parent1Idx = GetRandomIndex(Population.Num()); // Select Parent1 at random  
 		GenomePtr Parent1 = Population[Parent1Idx];
 
 		int Parent2Idx = -1; // Select Parent2 from a nearby neighbor (if crossover)
-		if (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate)
+		if (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate)
 		{
 			// Find a nearby neighbor with similar fitness  
 			double MinDistance = std::numeric_limits<double>::max();
@@ -667,7 +656,7 @@ TArray<Offspring> SimilarFitness(const TArray<GenomePtr>& Population, int Reprod
 		}
 
 		if (Parent2Idx != INDEX_NONE) OffspringList.Add(Offspring(Config, Parent1, Population[Parent2Idx])); // Crossover 
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -679,11 +668,11 @@ TArray<Offspring> DissimilarFitness(const TArray<GenomePtr>& Population, int Rep
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		int Parent1Idx = rand() % Population.Num(); // Select Parent1 at random  
+		int Parent1Idx = GetRandomIndex(Population.Num()); // Select Parent1 at random  
 		GenomePtr Parent1 = Population[Parent1Idx];
 
 		int Parent2Idx = -1; // Select Parent2 from a distant neighbor (if crossover)
-		if (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate)
+		if (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate)
 		{
 			// Find a distant neighbor with dissimilar fitness  
 			double MaxDistance = 0.0;
@@ -700,7 +689,7 @@ TArray<Offspring> DissimilarFitness(const TArray<GenomePtr>& Population, int Rep
 		}
 
 		if (Parent2Idx != INDEX_NONE) OffspringList.Add(Offspring(Config, Parent1, Population[Parent2Idx])); // Crossover 
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -713,11 +702,11 @@ TArray<Offspring> Proximity(const TArray<GenomePtr>& Population, int Reproductio
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		int Parent1Idx = rand() % Population.Num(); // Select Parent1 at random  
+		int Parent1Idx = GetRandomIndex(Population.Num()); // Select Parent1 at random  
 		GenomePtr Parent1 = Population[Parent1Idx];
 
 		int Parent2Idx = -1; // Select Parent2 from a nearby neighbor (if crossover)
-		if (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate)
+		if (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate)
 		{
 			// Find a nearby neighbor with similar genome  
 			double MinDistance = std::numeric_limits<double>::max();
@@ -734,7 +723,7 @@ TArray<Offspring> Proximity(const TArray<GenomePtr>& Population, int Reproductio
 		}
 
 		if (Parent2Idx != INDEX_NONE) OffspringList.Add(Offspring(Config, Parent1, Population[Parent2Idx])); // Crossover 
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -746,11 +735,11 @@ TArray<Offspring> Diversity(const TArray<GenomePtr>& Population, int Reproductio
 	TArray<Offspring> OffspringList;
 	for (int Idx = 0; Idx != ReproductionCount; ++Idx)
 	{
-		int Parent1Idx = rand() % Population.Num(); // Select Parent1 at random  
+		int Parent1Idx = GetRandomIndex(Population.Num()); // Select Parent1 at random  
 		GenomePtr Parent1 = Population[Parent1Idx];
 
 		int Parent2Idx = -1; // Select Parent2 from a distant neighbor (if crossover)
-		if (Config->CrossoverRate > 0.0 && (double)rand() / RAND_MAX < Config->CrossoverRate)
+		if (Config->CrossoverRate > 0.0 && GetRandomDouble(0.0, 1.0) < Config->CrossoverRate)
 		{
 			// Find a distant neighbor with dissimilar genome  
 			double MaxDistance = 0.0;
@@ -767,7 +756,7 @@ TArray<Offspring> Diversity(const TArray<GenomePtr>& Population, int Reproductio
 		}
 
 		if (Parent2Idx != INDEX_NONE) OffspringList.Add(Offspring(Config, Parent1, Population[Parent2Idx])); // Crossover 
-		else if ((double)rand() / RAND_MAX > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
+		else if (GetRandomDouble(0.0, 1.0) > 0.5) OffspringList.Add(Offspring(Config, Parent1)); // 50/50 chance of asexual reproduction with mutation 
 		else OffspringList.Add(Offspring(Config)); // 50% chance of random initialization
 	}
 
@@ -1011,7 +1000,7 @@ TArray<GenomePtr> RouletteWheel(const TArray<GenomePtr>& Population, size_t N)
 
 	while (SelectedGenomes.Num() < N)
 	{
-		double RandomFitness = (double)rand() / RAND_MAX * TotalFitness;
+		double RandomFitness = GetRandomDouble(0.0, 1.0) * TotalFitness;
 		double CurrentFitness = 0.0;
 		while (CurrentFitness < RandomFitness)
 		{
@@ -1046,7 +1035,7 @@ TArray<GenomePtr> Rank(const TArray<GenomePtr>& Population, size_t N)
 
 	while (SelectedGenomes.Num() < N)
 	{
-		double RandomRank = (double)rand() / RAND_MAX * TotalRank;
+		double RandomRank = GetRandomDouble(0.0, 1.0) * TotalRank;
 		double CurrentRank = 0.0;
 		for (size_t j = 0; j < Population.Num(); ++j)
 		{
@@ -1078,7 +1067,7 @@ TArray<GenomePtr> Boltzmann(const TArray<GenomePtr>& Population, size_t N)
 	double Temperature = 1.0;
 	while (SelectedGenomes.Num() < N)
 	{
-		double RandomFitness = (double)rand() / RAND_MAX * TotalFitness;
+		double RandomFitness = GetRandomDouble(0.0, 1.0) * TotalFitness;
 		double CurrentFitness = 0.0;
 		for (const auto& Genome : Population)
 		{
@@ -3,6 +3,7 @@
 #include <vector>  
 #include <string>  
 #include <memory>
+#include "Types.h"
 #include "Array.h"
 
 namespace NEAT
@@ -11,6 +12,7 @@ namespace NEAT
 	using GenomePtr = std::shared_ptr<NEAT::Genome>;
 
 	class Config;
+	struct Innovation;
 	//using ConfigPtr = std::shared_ptr<const NEAT::Config>;
 	using ConfigPtr = std::shared_ptr<NEAT::Config>;
 
@@ -36,8 +38,13 @@ namespace NEAT
 		}
 
 		GenomePtr InitializeFromParents(const GenomePtr& Parent1, const GenomePtr& Parent2); // Initialize a genome from two parents
+		GenomePtr InitializeFromParents(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID); // Initialize a genome from two parents, with an ID from Genome::ReserveGenomeIDs
 		GenomePtr InitializeFromParent(const GenomePtr& Parent); // Initialize a genome from a single parent
+		GenomePtr InitializeFromParent(const GenomePtr& Parent, uint64 ID); // Initialize a genome from a single parent, with an ID from Genome::ReserveGenomeIDs
 		GenomePtr InitializeGenome(const ConfigPtr& Config); // Initialize a single genome from Config defaults
+		GenomePtr InitializeGenome(const ConfigPtr& Config, uint64 ID); // Initialize a single genome from Config defaults, with an ID from Genome::ReserveGenomeIDs
+		void RegisterInnovations(const ConfigPtr& Config); // Numbers every connection the initial topology can create up front and in a fixed order, so that trackers reset from the same Config agree on them
+		const TArray<Innovation>& GetInitialConnections(const ConfigPtr& Config); // The numbered initial topology of the calling thread's tracker, which Sparse, Full and Tree copy instead of searching the tracker
 
 		void None(GenomePtr Genome); // Initialize connections for an initially unconnected neural network
 		void Sparse(GenomePtr Genome); // Initialize connections for a sparsely connected neural network
@@ -77,10 +84,10 @@ namespace NEAT
 			return ECrossoverType::Uniform;
 		}
 
-		GenomePtr Uniform(const GenomePtr& Parent1, const GenomePtr& Parent2); // Initialize a genome from two parents using Uniform crossover
-		GenomePtr SinglePoint(const GenomePtr& Parent1, const GenomePtr& Parent2); // Initialize a genome from two parents using Single Point crossover
-		GenomePtr TwoPoint(const GenomePtr& Parent1, const GenomePtr& Parent2); // Initialize a genome from two parents using Two Point crossover
-		GenomePtr Multipoint(const GenomePtr& Parent1, const GenomePtr& Parent2); // Initialize a genome from two parents using Multipoint crossover
+		GenomePtr Uniform(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID); // Initialize a genome with the given ID from two parents using Uniform crossover
+		GenomePtr SinglePoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID); // Initialize a genome with the given ID from two parents using Single Point crossover
+		GenomePtr TwoPoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID); // Initialize a genome with the given ID from two parents using Two Point crossover
+		GenomePtr Multipoint(const GenomePtr& Parent1, const GenomePtr& Parent2, uint64 ID); // Initialize a genome with the given ID from two parents using Multipoint crossover
 	}
 
 	enum class ECullingMethod
@@ -159,6 +166,7 @@ namespace NEAT
 			GenomePtr Parent1 = nullptr;
 			GenomePtr Parent2 = nullptr;
 			GenomePtr GetChild() const;
+			GenomePtr GetChild(uint64 ID) const; // With an ID from Genome::ReserveGenomeIDs, for children bred in parallel
 		};
 
 		TArray<Offspring> Random(const TArray<GenomePtr>& Population, int ReproductionCount, const ConfigPtr& Config);
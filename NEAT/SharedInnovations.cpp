@@ -0,0 +1,224 @@
+#include "SharedInnovations.h"
+#include "Utils.h"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NEAT
+{
+	namespace
+	{
+		constexpr uint64 SegmentMagic = 0x4E454154494E4E31ull; // Written last by the creating process, the segment is usable once it is set
+		constexpr uint64 EntryEmpty = 0;
+		constexpr uint64 EntryWriting = 1; // Claimed, the key is being written
+		constexpr uint64 EntryIDBase = 2; // A published entry stores EntryIDBase + its ID
+		constexpr int MaxWaitRounds = 100000; // Rounds a process waits on another before it gives up, so that a process that died mid-write can't stall the rest
+
+		void Backoff(int Rounds)
+		{
+			if (Rounds < 64) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+		uint64 HashInnovation(uint32 MutationType, uint32 GeneType, uint64 Input, uint64 Output)
+		{
+			uint64 Hash = (uint64(MutationType) << 32 | GeneType) * 0x9E3779B97F4A7C15ull;
+			for (uint64 Word : { Input, Output })
+			{
+				Hash ^= Word + 0x9E3779B97F4A7C15ull + (Hash << 6) + (Hash >> 2);
+				Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+				Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+				Hash ^= Hash >> 31;
+			}
+			return Hash;
+		}
+	}
+
+	struct SharedInnovationTable::SharedHeader
+	{
+		std::atomic<uint64> Magic;
+		uint64 Capacity;
+		std::atomic<uint64> NextInnovationID;
+	};
+
+	struct SharedInnovationTable::Entry
+	{
+		std::atomic<uint64> State;
+		uint32 MutationType;
+		uint32 GeneType;
+		uint64 Input;
+		uint64 Output;
+	};
+
+	SharedInnovationTable::SharedInnovationTable(const std::string& InName, int InCapacity)
+		: Name(InName.empty() || InName[0] == '/' ? InName : "/" + InName)
+		, Capacity(uint64(InCapacity > 0 ? InCapacity : 1 << 20))
+	{
+	}
+
+	SharedInnovationTable::~SharedInnovationTable()
+	{
+		Close();
+	}
+
+	bool SharedInnovationTable::IsSupported()
+	{
+#ifdef _WIN32
+		return false;
+#else
+		return true;
+#endif
+	}
+
+	SharedInnovationTable::Entry* SharedInnovationTable::GetEntry(uint64 EntryIdx) const
+	{
+		return reinterpret_cast<Entry*>(Mapping + 64 + EntryIdx * sizeof(Entry)); // The shared header occupies the first cache line
+	}
+
+	bool SharedInnovationTable::FindOrAdd(uint32 MutationType, uint32 GeneType, uint64 Input, uint64 Output, uint64& OutID)
+	{
+		if (!Mapping) return false;
+
+		auto* Header = reinterpret_cast<SharedHeader*>(Mapping);
+		const uint64 Hash = HashInnovation(MutationType, GeneType, Input, Output);
+		for (uint64 Probe = 0; Probe != Capacity; ++Probe) // Linear probing, entries are never removed so a lookup can stop at the first empty entry
+		{
+			Entry* Current = GetEntry((Hash + Probe) % Capacity);
+			uint64 State = Current->State.load(std::memory_order_acquire);
+			if (State == EntryEmpty)
+			{
+				if (Current->State.compare_exchange_strong(State, EntryWriting, std::memory_order_acq_rel))
+				{
+					Current->MutationType = MutationType;
+					Current->GeneType = GeneType;
+					Current->Input = Input;
+					Current->Output = Output;
+					OutID = Header->NextInnovationID.fetch_add(1, std::memory_order_relaxed);
+					Current->State.store(EntryIDBase + OutID, std::memory_order_release);
+					return true;
+				}
+				// Another process claimed it first, State now holds what it wrote
+			}
+
+			for (int Rounds = 0; State == EntryWriting; State = Current->State.load(std::memory_order_acquire))
+			{
+				if (++Rounds == MaxWaitRounds)
+				{
+					LogMessage(LogLevel::Error, "Shared innovations: gave up waiting on an entry of " + Name + ", the process writing it may have died");
+					return false;
+				}
+				Backoff(Rounds);
+			}
+
+			if (Current->MutationType == MutationType && Current->GeneType == GeneType && Current->Input == Input && Current->Output == Output)
+			{
+				OutID = State - EntryIDBase;
+				return true;
+			}
+		}
+
+		if (!bReportedFull.exchange(true)) LogMessage(LogLevel::Error, "Shared innovations: " + Name + " is full, new innovations are numbered by each process on its own");
+		return false;
+	}
+
+	void SharedInnovationTable::RaiseNextID(uint64 MinimumID)
+	{
+		if (!Mapping) return;
+
+		auto& NextInnovationID = reinterpret_cast<SharedHeader*>(Mapping)->NextInnovationID;
+		uint64 Current = NextInnovationID.load(std::memory_order_relaxed);
+		while (Current < MinimumID && !NextInnovationID.compare_exchange_weak(Current, MinimumID, std::memory_order_relaxed)) {}
+	}
+
+#ifndef _WIN32
+	bool SharedInnovationTable::Open()
+	{
+		if (Mapping) return true;
+
+		bool bCreated = true;
+		int File = shm_open(Name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (File < 0)
+		{
+			bCreated = false;
+			File = shm_open(Name.c_str(), O_RDWR, 0600);
+		}
+		if (File < 0)
+		{
+			LogMessage(LogLevel::Error, "Shared innovations: failed to open shared memory segment " + Name);
+			return false;
+		}
+
+		if (bCreated)
+		{
+			MappingSize = 64 + Capacity * sizeof(Entry);
+			if (ftruncate(File, off_t(MappingSize)) != 0)
+			{
+				LogMessage(LogLevel::Error, "Shared innovations: failed to size shared memory segment " + Name);
+				close(File);
+				shm_unlink(Name.c_str());
+				return false;
+			}
+		}
+		else // The creating process sizes the segment, which also decides its capacity
+		{
+			struct stat Status = {};
+			for (int Rounds = 0; fstat(File, &Status) == 0 && Status.st_size == 0 && Rounds != MaxWaitRounds; ++Rounds) Backoff(Rounds);
+			MappingSize = size_t(Status.st_size);
+		}
+
+		void* Memory = MappingSize > 64 ? mmap(nullptr, MappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0) : MAP_FAILED;
+		close(File);
+		if (Memory == MAP_FAILED)
+		{
+			LogMessage(LogLevel::Error, "Shared innovations: failed to map shared memory segment " + Name);
+			return false;
+		}
+
+		Mapping = static_cast<uint8*>(Memory);
+		auto* Header = reinterpret_cast<SharedHeader*>(Mapping);
+		if (bCreated) // ftruncate zero-fills the segment, so every entry starts out empty
+		{
+			new (Header) SharedHeader{ { 0 }, Capacity, { 0 } };
+			Header->Magic.store(SegmentMagic, std::memory_order_release);
+		}
+		else
+		{
+			for (int Rounds = 0; Header->Magic.load(std::memory_order_acquire) != SegmentMagic && Rounds != MaxWaitRounds; ++Rounds) Backoff(Rounds);
+			if (Header->Magic.load(std::memory_order_acquire) != SegmentMagic || 64 + Header->Capacity * sizeof(Entry) > MappingSize)
+			{
+				LogMessage(LogLevel::Error, "Shared innovations: " + Name + " is not an innovation table");
+				Close();
+				return false;
+			}
+			Capacity = Header->Capacity;
+		}
+
+		LogMessage(LogLevel::Info, std::string("Shared innovations: ") + (bCreated ? "created " : "opened ") + Name + " with room for " + std::to_string(Capacity) + " innovations");
+		return true;
+	}
+
+	void SharedInnovationTable::Close()
+	{
+		if (!Mapping) return;
+		munmap(Mapping, MappingSize);
+		Mapping = nullptr;
+	}
+
+	void SharedInnovationTable::Remove(const std::string& Name)
+	{
+		shm_unlink((Name.empty() || Name[0] == '/' ? Name : "/" + Name).c_str());
+	}
+#else
+	bool SharedInnovationTable::Open() { return false; }
+	void SharedInnovationTable::Close() { }
+	void SharedInnovationTable::Remove(const std::string& Name) { }
+#endif
+} // namespace NEAT
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "Types.h"
+
+// Innovation numbering shared by cooperating trainer processes on one host, such as parallel restarts or islands run as separate processes.
+// The innovations live in a named shared-memory segment that every process maps, as an open-addressing hash table keyed by the structure of the innovation.
+// Entries are claimed with compare-and-swap and never removed, so processes look up and add innovations without locks and all of them give the same ID to the same innovation.
+// The segment outlives the processes that use it until Remove is called. Only available on POSIX systems.
+
+namespace NEAT
+{
+	class SharedInnovationTable
+	{
+	public:
+		SharedInnovationTable(const std::string& InName, int InCapacity);
+		~SharedInnovationTable();
+
+		SharedInnovationTable(const SharedInnovationTable&) = delete;
+		SharedInnovationTable& operator=(const SharedInnovationTable&) = delete;
+
+		static bool IsSupported(); // Returns false on platforms without POSIX shared memory
+		static void Remove(const std::string& Name); // Removes the named segment, processes that mapped it keep their mapping
+
+		bool Open(); // Maps the named segment, creating it with room for Capacity innovations if no process created it yet
+		void Close(); // Unmaps the segment
+		bool IsOpen() const { return Mapping != nullptr; }
+
+		bool FindOrAdd(uint32 MutationType, uint32 GeneType, uint64 Input, uint64 Output, uint64& OutID); // Returns the ID of the innovation, numbering it if no process did yet. Returns false once the table is full
+		void RaiseNextID(uint64 MinimumID); // Numbers new innovations from at least MinimumID, for trackers reset past their initial nodes
+
+	private:
+		struct SharedHeader;
+		struct Entry;
+
+		Entry* GetEntry(uint64 EntryIdx) const;
+
+		std::string Name;
+		uint64 Capacity = 0;
+		size_t MappingSize = 0;
+		uint8* Mapping = nullptr;
+		std::atomic<bool> bReportedFull = false;
+	};
+
+	using SharedInnovationTablePtr = std::shared_ptr<SharedInnovationTable>;
+} // namespace NEAT
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Array.h"
+
+// A map stored as one contiguous array of key-value pairs sorted by key, with the interface of TMap.
+// Iteration is a linear scan in key order and lookups are binary searches. Adding a key larger than every key in the map, the common case for innovation IDs, appends.
+// Unlike TMap, adding or removing entries moves the entries after them, so pointers and references into the map are only valid until it is next changed.
+// Allocator allocates the array, such as TArenaAllocator for genes.
+// Copies share the array until one of them is changed, which then copies it first, so copying a map is O(1) and a genome cloned from its parent costs no gene memory
+// until it is mutated. Every non-const accessor that can change an entry, including non-const iteration and operator[], makes the array unshared first. Reads from
+// maps that other threads may copy or read at the same time must therefore go through const accessors, and references taken from a map must not outlive a copy of it.
+// Those accessors also flag the map as changed (see IsChanged), so that its owner can tell when something it derived from the entries is out of date.
+
+template<typename Key, typename Value, typename Allocator = std::allocator<std::pair<Key, Value>>>
+class TSortedMap
+{
+public:
+	using PairType = std::pair<Key, Value>;
+	using ArrayType = std::vector<PairType, Allocator>;
+
+	TSortedMap() = default;
+	~TSortedMap() { Release(); }
+
+	TSortedMap(TSortedMap&& Other) noexcept : Shared(Other.Shared), bChanged(Other.bChanged) { Other.Shared = nullptr; }
+	TSortedMap(const TSortedMap& Other) : Shared(Other.Shared), bChanged(Other.bChanged) { AddRef(); } // Shares the array
+
+	TSortedMap& operator=(const TSortedMap& Other)
+	{
+		if (this != &Other)
+		{
+			Other.AddRef();
+			Release();
+			Shared = Other.Shared;
+			bChanged = Other.bChanged;
+		}
+		return *this;
+	}
+
+	TSortedMap& operator=(TSortedMap&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			Release();
+			Shared = Other.Shared;
+			bChanged = Other.bChanged;
+			Other.Shared = nullptr;
+		}
+		return *this;
+	}
+
+	void Add(const Key& InKey, const Value& InValue)
+	{
+		FindOrAdd(InKey) = InValue;
+	}
+
+	bool Contains(const Key& InKey) const
+	{
+		return Find(InKey) != nullptr;
+	}
+
+	template<typename Predicate>
+	bool ContainsByPredicate(Predicate Pred) const
+	{
+		for (const auto& Pair : Read())
+		{
+			if (Pred(Pair))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Value* Find(const Key& InKey) // Only makes the array unshared when the key is found
+	{
+		const int Idx = IndexOf(InKey);
+		return Idx != -1 ? &Write()[Idx].second : nullptr;
+	}
+
+	const Value* Find(const Key& InKey) const
+	{
+		const int Idx = IndexOf(InKey);
+		return Idx != -1 ? &Read()[Idx].second : nullptr;
+	}
+
+	template<typename Predicate>
+	Value* FindByPredicate(Predicate Pred)
+	{
+		const ArrayType& Array = Read();
+		for (size_t Idx = 0; Idx != Array.size(); ++Idx)
+		{
+			if (Pred(Array[Idx]))
+			{
+				return &Write()[Idx].second;
+			}
+		}
+		return nullptr;
+	}
+
+	template<typename Predicate>
+	const Value* FindByPredicate(Predicate Pred) const
+	{
+		for (const auto& Pair : Read())
+		{
+			if (Pred(Pair))
+			{
+				return &Pair.second;
+			}
+		}
+		return nullptr;
+	}
+
+	int Remove(const Key& InKey)
+	{
+		const int Idx = IndexOf(InKey);
+		if (Idx == -1) return 0;
+		ArrayType& Array = Write();
+		Array.erase(Array.begin() + Idx);
+		return 1;
+	}
+
+	template<typename Predicate>
+	int RemoveByPredicate(Predicate Pred)
+	{
+		if (!ContainsByPredicate(Pred)) return 0; // Nothing to remove, the array stays shared
+		ArrayType& Array = Write();
+		auto NewEnd = std::remove_if(Array.begin(), Array.end(), Pred); // Keeps the order of the remaining pairs
+		int NumRemoved = int(std::distance(NewEnd, Array.end()));
+		Array.erase(NewEnd, Array.end());
+		return NumRemoved;
+	}
+
+	void Reserve(int Num)
+	{
+		Write().reserve(Num);
+	}
+
+	void ShrinkToFit()
+	{
+		if (IsUnique()) Shared->Pairs.shrink_to_fit(); // A shared array is only copied once it changes, at its exact size
+	}
+
+	template<typename Predicate>
+	TArray<Key> FilterKeysByPredicate(Predicate Pred) const
+	{
+		TArray<Key> Keys;
+		for (const auto& Pair : Read())
+		{
+			if (Pred(Pair))
+			{
+				Keys.Add(Pair.first);
+			}
+		}
+		return Keys;
+	}
+
+	template<typename Predicate>
+	TArray<Value> FilterValuesByPredicate(Predicate Pred) const
+	{
+		TArray<Value> Values;
+		for (const auto& Pair : Read())
+		{
+			if (Pred(Pair))
+			{
+				Values.Add(Pair.second);
+			}
+		}
+		return Values;
+	}
+
+	template<typename Predicate>
+	TSortedMap FilterByPredicate(Predicate Pred) const
+	{
+		TSortedMap FilteredMap;
+		ArrayType& FilteredPairs = FilteredMap.Write();
+		FilteredPairs.reserve(Num());
+		for (const auto& Pair : Read())
+		{
+			if (Pred(Pair))
+			{
+				FilteredPairs.push_back(Pair); // Already in order
+			}
+		}
+		return FilteredMap;
+	}
+
+	Value& FindOrAdd(const Key& InKey)
+	{
+		ArrayType& Array = Write();
+		if (Array.empty() || Array.back().first < InKey) // Appending is the common case, new genes get the newest innovation IDs
+		{
+			return Array.emplace_back(InKey, Value()).second;
+		}
+
+		auto It = std::lower_bound(Array.begin(), Array.end(), InKey, ComparePair);
+		if (It != Array.end() && It->first == InKey)
+		{
+			return It->second;
+		}
+		return Array.emplace(It, InKey, Value())->second;
+	}
+
+	Value& FindOrAdd(const Key& InKey, const Value& InValue)
+	{
+		if (Value* Found = Find(InKey))
+		{
+			return *Found;
+		}
+		return FindOrAdd(InKey) = InValue;
+	}
+
+	void Clear()
+	{
+		bChanged = true;
+		if (IsUnique()) Shared->Pairs.clear(); // Keeps the capacity for refilling
+		else Release();
+	}
+
+	void Reset()
+	{
+		Clear();
+	}
+
+	bool IsEmpty() const
+	{
+		return Read().empty();
+	}
+
+	bool IsChanged() const // Whether the map may have changed since ClearChanged, set by every non-const accessor that can change an entry
+	{
+		return bChanged;
+	}
+
+	void ClearChanged()
+	{
+		bChanged = false;
+	}
+
+	TArray<Key> GetKeys() const
+	{
+		TArray<Key> Keys;
+		Keys.Reserve(Num());
+		for (const auto& Pair : Read())
+		{
+			Keys.Add(Pair.first);
+		}
+		return Keys;
+	}
+
+	TArray<Value> GetValues() const
+	{
+		TArray<Value> Values;
+		Values.Reserve(Num());
+		for (const auto& Pair : Read())
+		{
+			Values.Add(Pair.second);
+		}
+		return Values;
+	}
+
+	Value& operator[](const Key& InKey)
+	{
+		return FindOrAdd(InKey);
+	}
+
+	const Value& operator[](const Key& InKey) const
+	{
+		const Value* Found = Find(InKey);
+		if (!Found) throw std::out_of_range("TSortedMap key not found");
+		return *Found;
+	}
+
+	int Num() const
+	{
+		return int(Read().size());
+	}
+
+	int IndexOf(const Key& InKey) const // The position of the key in key order, or -1 if it isn't in the map
+	{
+		const ArrayType& Array = Read();
+		auto It = std::lower_bound(Array.begin(), Array.end(), InKey, ComparePair);
+		return It != Array.end() && It->first == InKey ? int(It - Array.begin()) : -1;
+	}
+
+	const PairType& GetPairAt(int Idx) const // The pair at a position in key order, for picking entries at random in O(1)
+	{
+		return Read()[Idx];
+	}
+
+	const Value& GetValueAt(int Idx) const
+	{
+		return Read()[Idx].second;
+	}
+
+	Value& GetValueAt(int Idx)
+	{
+		return Write()[Idx].second;
+	}
+
+	void RemoveAt(int Idx)
+	{
+		ArrayType& Array = Write();
+		Array.erase(Array.begin() + Idx);
+	}
+
+	auto begin() const { return Read().begin(); }
+	auto end() const { return Read().end(); }
+	auto begin() { return Write().begin(); }
+	auto end() { return Write().end(); }
+
+private:
+	static bool ComparePair(const PairType& Pair, const Key& Search) { return Pair.first < Search; }
+
+	static const ArrayType& GetEmptyArray()
+	{
+		static const ArrayType EmptyArray;
+		return EmptyArray;
+	}
+
+	// The array and the number of maps that share it
+	struct SharedArray
+	{
+		SharedArray() = default;
+		SharedArray(const ArrayType& InPairs) : Pairs(InPairs) {}
+
+		std::atomic<int> NumRefs = 1;
+		ArrayType Pairs;
+	};
+	using SharedAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SharedArray>;
+
+	template<typename... Args>
+	static SharedArray* NewSharedArray(Args&&... InArgs)
+	{
+		SharedAllocator ArrayAllocator;
+		SharedArray* Array = std::allocator_traits<SharedAllocator>::allocate(ArrayAllocator, 1);
+		try
+		{
+			return new (Array) SharedArray(std::forward<Args>(InArgs)...);
+		}
+		catch (...)
+		{
+			std::allocator_traits<SharedAllocator>::deallocate(ArrayAllocator, Array, 1);
+			throw;
+		}
+	}
+
+	void AddRef() const
+	{
+		if (Shared) Shared->NumRefs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void Release()
+	{
+		if (Shared && Shared->NumRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			SharedAllocator ArrayAllocator;
+			Shared->~SharedArray();
+			std::allocator_traits<SharedAllocator>::deallocate(ArrayAllocator, Shared, 1);
+		}
+		Shared = nullptr;
+	}
+
+	bool IsUnique() const
+	{
+		return Shared && Shared->NumRefs.load(std::memory_order_acquire) == 1; // Acquire, so that changing it in place is ordered after the reads of the maps that released it
+	}
+
+	const ArrayType& Read() const
+	{
+		return Shared ? Shared->Pairs : GetEmptyArray();
+	}
+
+	ArrayType& Write() // Makes the array unshared, copying it if another map reads it
+	{
+		bChanged = true;
+		if (!Shared) Shared = NewSharedArray();
+		else if (!IsUnique())
+		{
+			SharedArray* Copy = NewSharedArray(Shared->Pairs);
+			Release();
+			Shared = Copy;
+		}
+		return Shared->Pairs;
+	}
+
+	SharedArray* Shared = nullptr; // Null while empty
+	bool bChanged = false;
+};
@@ -2,15 +2,14 @@
 #include "Genome.h"	
 #include "Utils.h"
 #include "Math.h"
+#include "EvolutionContext.h"
 
 namespace NEAT
 {
-	static unsigned NextSpeciesID = 0;
-
 	Species::Species(const GenomePtr& InRepresentative, const ConfigPtr& InConfig)
 		: Config(InConfig)
 		, Representative(InRepresentative)
-		, ID(++NextSpeciesID)
+		, ID(GetContext().GenerateSpeciesID())
 	{
 	}
 
@@ -19,6 +18,11 @@ namespace NEAT
 	}
 
 	double Species::GetAverageGenomeDistance() const
+	{
+		return GetAverageGenomeDistance(Genomes, Config);
+	}
+
+	double Species::GetAverageGenomeDistance(const TArray<GenomePtr>& Genomes, const ConfigPtr& Config)
 	{
 		double TotalDistance = 0.0;
 		int NumGenomes = Genomes.Num();
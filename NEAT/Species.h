@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "Types.h"
 #include "Array.h"
 
 namespace NEAT
@@ -24,12 +25,13 @@ namespace NEAT
 		int DesiredPopulationSize = 0;
 		unsigned Stagnation = 0;
 		bool IsStagnant = false;
-		unsigned ID = 0;
+		uint64 ID = 0;
 
 		Species(const GenomePtr& InRepresentative, const ConfigPtr& Config);
 		~Species();
 
 		double GetAverageGenomeDistance() const;
+		static double GetAverageGenomeDistance(const TArray<GenomePtr>& Genomes, const ConfigPtr& Config); // Over every pair of Genomes
 		
 		GenomePtr GetRandomGenome() const;
 		GenomePtr GetBestGenome() const;
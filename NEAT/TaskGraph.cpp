@@ -0,0 +1,174 @@
+#include "TaskGraph.h"
+#include "Utils.h"
+#include "EvolutionContext.h"
+#include <vector>
+
+namespace NEAT
+{
+	TaskGraph::~TaskGraph()
+	{
+		WaitForBackground();
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bStopping = true;
+		}
+		BackgroundCondition.notify_all();
+		if (BackgroundThread.joinable()) BackgroundThread.join();
+	}
+
+	TaskGraph::TaskID TaskGraph::Add(const std::string& Name, std::function<void()> Work, std::initializer_list<TaskID> Dependencies)
+	{
+		return AddTask(Name, std::move(Work), Dependencies, false);
+	}
+
+	TaskGraph::TaskID TaskGraph::AddBackground(const std::string& Name, std::function<void()> Work, std::initializer_list<TaskID> Dependencies)
+	{
+		return AddTask(Name, std::move(Work), Dependencies, true);
+	}
+
+	TaskGraph::TaskID TaskGraph::AddTask(const std::string& Name, std::function<void()>&& Work, std::initializer_list<TaskID> Dependencies, bool bBackground)
+	{
+		const TaskID ID = Tasks.Num();
+		Task& NewTask = Tasks.AddGetRef(Task());
+		NewTask.Name = Name;
+		NewTask.Work = std::move(Work);
+		NewTask.bBackground = bBackground;
+		for (TaskID Dependency : Dependencies)
+		{
+			if (!Tasks.IsValidIndex(Dependency) || Dependency == ID || Tasks[Dependency].bBackground) continue; // Only earlier foreground tasks, which keeps the graph acyclic
+			Tasks[Dependency].Dependents.Add(ID);
+			NewTask.NumDependencies++;
+		}
+		return ID;
+	}
+
+	void TaskGraph::Run(int NumThreads)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Ready.clear();
+			NumForegroundLeft = 0;
+			Failure = nullptr;
+			for (TaskID ID = 0, NumTasks = Tasks.Num(); ID != NumTasks; ++ID)
+			{
+				if (!Tasks[ID].bBackground) NumForegroundLeft++;
+				if (Tasks[ID].NumDependencies == 0 && !Tasks[ID].bBackground) Ready.push_back(ID);
+				else if (Tasks[ID].NumDependencies == 0) BackgroundQueue.push_back(std::move(Tasks[ID]));
+			}
+			if (!BackgroundQueue.empty()) StartBackground();
+		}
+
+		std::vector<std::thread> Threads;
+		EvolutionContext* Context = GetBoundContext(); // Tasks run for the caller's trainer on any thread
+		for (int Idx = 1; Idx < NumThreads; ++Idx) Threads.emplace_back([this, Context]() { ScopedContext BoundContext(Context); RunForeground(); });
+		RunForeground();
+		for (auto& Thread : Threads) Thread.join();
+
+		std::exception_ptr RunFailure = nullptr;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Tasks.Reset(); // Background tasks whose dependencies failed are dropped with the rest
+			RunFailure = Failure;
+			Failure = nullptr;
+		}
+		if (RunFailure) std::rethrow_exception(RunFailure);
+	}
+
+	void TaskGraph::RunForeground()
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+		while (true)
+		{
+			ReadyCondition.wait(Lock, [this]() { return !Ready.empty() || NumForegroundLeft == 0; });
+			if (NumForegroundLeft == 0) return;
+
+			const TaskID ID = Ready.front();
+			Ready.pop_front();
+			std::function<void()> Work = std::move(Tasks[ID].Work);
+			Lock.unlock();
+
+			std::exception_ptr TaskFailure = nullptr;
+			try
+			{
+				Work();
+			}
+			catch (...)
+			{
+				TaskFailure = std::current_exception();
+			}
+
+			Lock.lock();
+			if (TaskFailure) // The tasks that depend on it can't run, so the rest of the graph is abandoned
+			{
+				if (!Failure) Failure = TaskFailure;
+				Ready.clear();
+				NumForegroundLeft = 0;
+			}
+			else
+			{
+				Complete(ID);
+				NumForegroundLeft--;
+			}
+			ReadyCondition.notify_all();
+		}
+	}
+
+	void TaskGraph::Complete(TaskID ID)
+	{
+		bool bBackgroundReady = false;
+		for (TaskID Dependent : Tasks[ID].Dependents)
+		{
+			Task& DependentTask = Tasks[Dependent];
+			if (--DependentTask.NumDependencies != 0) continue;
+			if (!DependentTask.bBackground) Ready.push_back(Dependent);
+			else
+			{
+				BackgroundQueue.push_back(std::move(DependentTask));
+				bBackgroundReady = true;
+			}
+		}
+
+		if (bBackgroundReady) StartBackground();
+	}
+
+	void TaskGraph::StartBackground()
+	{
+		if (!BackgroundThread.joinable()) BackgroundThread = std::thread([this]() { RunBackground(); });
+		BackgroundCondition.notify_all();
+	}
+
+	void TaskGraph::RunBackground()
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+		while (true)
+		{
+			BackgroundCondition.wait(Lock, [this]() { return !BackgroundQueue.empty() || bStopping; });
+			if (BackgroundQueue.empty()) return;
+
+			Task BackgroundTask = std::move(BackgroundQueue.front());
+			BackgroundQueue.pop_front();
+			bBackgroundBusy = true;
+			Lock.unlock();
+
+			try
+			{
+				BackgroundTask.Work();
+			}
+			catch (const std::exception& Exception) // Nothing waits on the result, so the failure is only reported
+			{
+				LogMessage(LogLevel::Error, "Background task " + BackgroundTask.Name + " failed: " + Exception.what());
+			}
+
+			Lock.lock();
+			bBackgroundBusy = false;
+			BackgroundCondition.notify_all();
+		}
+	}
+
+	void TaskGraph::WaitForBackground()
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+		if (!BackgroundThread.joinable()) return;
+		BackgroundCondition.wait(Lock, [this]() { return BackgroundQueue.empty() && !bBackgroundBusy; });
+	}
+} // namespace NEAT
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Types.h"
+#include "Array.h"
+
+// Dependency-driven scheduling of the phases of a generation.
+// A task runs once every task it depends on finished. Foreground tasks run on the threads of Run, which returns once all of them are done.
+// Background tasks run one at a time, in the order they became ready, on a thread of their own that outlives Run, so that reporting and file writes
+// overlap with the next generation instead of delaying it. The trainer moves on while they run, so they should only read snapshots.
+
+namespace NEAT
+{
+	class TaskGraph
+	{
+	public:
+		using TaskID = int;
+
+		TaskGraph() = default;
+		~TaskGraph();
+
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		TaskID Add(const std::string& Name, std::function<void()> Work, std::initializer_list<TaskID> Dependencies = {}); // Adds a foreground task that runs after Dependencies, tasks added earlier
+		TaskID AddBackground(const std::string& Name, std::function<void()> Work, std::initializer_list<TaskID> Dependencies = {}); // Adds a background task, which may only depend on foreground tasks
+		void Run(int NumThreads); // Runs the added tasks, the foreground ones on NumThreads threads counting the caller, and empties the graph. Rethrows the first exception a foreground task threw
+		void WaitForBackground(); // Waits until every background task that became ready finished
+
+	private:
+		struct Task
+		{
+			std::string Name;
+			std::function<void()> Work;
+			TArray<TaskID> Dependents;
+			int NumDependencies = 0;
+			bool bBackground = false;
+		};
+
+		TaskID AddTask(const std::string& Name, std::function<void()>&& Work, std::initializer_list<TaskID> Dependencies, bool bBackground);
+		void RunForeground(); // Runs ready foreground tasks until none are left
+		void Complete(TaskID ID); // Releases the dependents of a finished task, called with Mutex held
+		void StartBackground(); // Wakes the background thread for newly queued tasks, starting it on first use, called with Mutex held
+		void RunBackground(); // The loop of the background thread
+
+		TArray<Task> Tasks;
+		std::deque<TaskID> Ready;
+		int NumForegroundLeft = 0;
+		std::exception_ptr Failure = nullptr;
+		std::mutex Mutex;
+		std::condition_variable ReadyCondition;
+
+		std::deque<Task> BackgroundQueue;
+		bool bBackgroundBusy = false;
+		bool bStopping = false;
+		std::thread BackgroundThread;
+		std::condition_variable BackgroundCondition;
+	};
+} // namespace NEAT
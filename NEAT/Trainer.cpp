@@ -10,33 +10,203 @@
 #include "Network.h"
 #include "Utils.h"
 #include "Timer.h"
+#include "Random.h"
+#include "Distributed.h"
+#include "ProcessWorkers.h"
+#include "SharedInnovations.h"
+#include "FitnessCache.h"
+#include "Affinity.h"
+#include "TaskGraph.h"
 #include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <thread>
 #include <mutex>
+#include <functional>
+#include <limits>
+
+// The best fitness values completed so far in one species. Once NumSurvivors genomes of the species finished evaluating, the smallest of them is the fitness
+// any other genome has to reach to survive elitism culling
+struct NEAT::Trainer::SpeciesCutoff
+{
+	std::mutex Mutex;
+	TArray<double> BestFitness; // Min-heap of at most NumSurvivors values
+	int NumSurvivors = 0;
+	std::atomic<double> Threshold = -std::numeric_limits<double>::max();
+
+	void Record(double Fitness)
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		auto& Heap = BestFitness.GetArray();
+		if (int(Heap.size()) < NumSurvivors)
+		{
+			Heap.push_back(Fitness);
+			std::push_heap(Heap.begin(), Heap.end(), std::greater<double>());
+		}
+		else if (Fitness > Heap.front())
+		{
+			std::pop_heap(Heap.begin(), Heap.end(), std::greater<double>());
+			Heap.back() = Fitness;
+			std::push_heap(Heap.begin(), Heap.end(), std::greater<double>());
+		}
+
+		if (int(Heap.size()) == NumSurvivors) Threshold.store(Heap.front(), std::memory_order_relaxed);
+	}
+};
+
+struct NEAT::Trainer::EvaluationBounds
+{
+	SpeciesCutoff* Cutoff = nullptr;
+	double BestFitness = -std::numeric_limits<double>::max();
+	double PartialFitness = 0.0;
+	bool bTerminated = false;
+	bool bCacheable = true;
+};
+
+namespace
+{
+	// Bounds of the evaluation running on the calling thread, set by EvaluateGenome and the async scheduler for ReportPartialFitness
+	thread_local NEAT::Trainer::EvaluationBounds* CurrentBounds = nullptr;
+
+	// Queue index of the first genome of the batch being evaluated on the calling thread, and the number of genomes evaluated through EvaluateGenome on it,
+	// which tells the scheduler whether EvaluateBatch was overridden
+	thread_local int CurrentBatchStart = 0;
+	thread_local uint64 NumGenomeEvaluations = 0;
+
+	// A coroutine evaluation in flight on an async evaluation thread, with the state that has to survive its suspensions
+	struct AsyncEvaluation
+	{
+		NEAT::GenomePtr Genome = nullptr;
+		NEAT::NeuralNetworkPtr Network = nullptr;
+		NEAT::EvaluationTask Task;
+		NEAT::Trainer::EvaluationBounds Bounds;
+		NEAT::RandomStream Stream;
+	};
+
+	// The species statistics SerializePopulationInfo writes for one generation, copied so that they can be written while the trainer moves on
+	struct PopulationInfo
+	{
+		struct SpeciesInfo
+		{
+			uint64 ID = 0;
+			int Size = 0;
+			unsigned Stagnation = 0;
+			double AdjustedFitness = 0.0;
+		};
+
+		std::time_t Timestamp = 0;
+		TArray<SpeciesInfo> Species;
+	};
+
+	PopulationInfo CapturePopulationInfo(const TArray<NEAT::SpeciesPtr>& Species)
+	{
+		PopulationInfo Info;
+		Info.Timestamp = std::time(0);
+		Info.Species.Reserve(Species.Num());
+		for (const auto& Specie : Species) Info.Species.Add(PopulationInfo::SpeciesInfo{ Specie->ID, Specie->Genomes.Num(), Specie->Stagnation, Specie->AdjustedFitness });
+		return Info;
+	}
+
+	// Appends the generation to the JSON array in Filename, creating the file if it doesn't exist yet
+	void WritePopulationInfo(const std::string& Filename, const PopulationInfo& Info)
+	{
+		// Check if the file is empty  
+		std::ifstream CheckFile(Filename);
+		bool isEmpty = CheckFile.peek() == std::ifstream::traits_type::eof();
+		CheckFile.close();
+
+		auto WriteSpecies = [&Info](std::ostream& File)
+		{
+			// Serialize the population info to the file in JSON format
+			File << "{\"timestamp\": " << Info.Timestamp << ", \"species\": [" << std::endl;
+			for (int Idx = 0, StopIdx = Info.Species.Num(); Idx != StopIdx; ++Idx)
+			{
+				const auto& Specie = Info.Species[Idx];
+				File << "  {\"id\": " << Specie.ID << ", \"size\": " << Specie.Size << ", \"stagnation\": " << Specie.Stagnation << ", \"adjusted_fitness\": " << Specie.AdjustedFitness << "}";
+				if (Idx == StopIdx - 1) File << std::endl;
+				else File << "," << std::endl;
+			}
+			File << "]}]";
+		};
+
+		if (isEmpty)
+		{
+			// Create the file and any necessary folders that don't already exist, without filesystem  
+			std::ofstream File(Filename, std::ios_base::app);
+			if (!File.is_open()) return;
+
+			File << "["; // If empty, add a "[" to the beginning of the file
+			WriteSpecies(File);
+			File.close(); // Add this line to close the file and release memory
+		}
+		else
+		{
+			// If not empty, remove the last "]" and add a ","  
+			std::fstream File(Filename, std::ios_base::in | std::ios_base::out);
+			File.seekg(-1, std::ios_base::end);
+			File << "," << std::endl;
+			WriteSpecies(File);
+			File.close(); // Add this line to close the file and release memory
+		}
+	}
+}
 
 // Called once before training begins, using Config settings to initialize the population
 void NEAT::Trainer::Initialize() 
 {
+	ScopedContext BoundContext(Context.get());
+
 	// Clear the existing population and species
 	Population.Reset();
 	Species.Reset();
 	BestGenome = NEAT::Genome(Config);
 	Generation = 0;
 
-	Innovations.Reset(Config->NumInputs + Config->NumOutputs + Config->NumHidden + 1); // Reset the innovation tracker, with the number of inputs, outputs, and hidden nodes, plus one for the bias node
-	
-	std::vector<GenomePairing::Offspring> InitialPopulation; // Create the initial population
-	for (unsigned Idx = 0; Idx < Config->PopulationSize; ++Idx)
+	InitializeRandomSeed(Config->RandomSeed); // Seed the random streams so that a run is reproducible from Config->RandomSeed
+	Config->PrepareMutationTables();
+	if (Config->GenerationArena) GenerationArena::Configure(true, Config->ArenaHugePages);
+
+	if (Config->DistributedEvaluation && !Coordinator)
+	{
+		Coordinator = std::make_shared<Distributed::Coordinator>(Config);
+		if (!Coordinator->Listen(Config->DistributedPort)) Coordinator = nullptr; // Fall back to local evaluation
+	}
+
+	const bool bFitnessStore = !Config->FitnessStoreFile.empty();
+	Cache = Config->FitnessCaching || bFitnessStore ? std::make_shared<FitnessCache>(Config->FitnessCacheSize) : nullptr;
+	if (bFitnessStore)
+	{
+		if (!FitnessStore::IsSupported()) LogMessage(LogLevel::Warning, "The fitness store is not supported on this platform, caching fitness values for this run only");
+		else
+		{
+			auto Store = std::make_shared<FitnessStore>(Config->FitnessStoreFile, Config->FitnessStoreVersion, Config->FitnessStoreCapacity);
+			if (Store->Open()) Cache->SetStore(Store); // Otherwise the cache only lasts for this run
+		}
+	}
+
+	if (Config->ProcessEvaluation && !ProcessWorkers)
 	{
-		InitialPopulation.push_back(GenomePairing::Offspring(Config));
+		if (!ProcessEvaluator::IsSupported()) LogMessage(LogLevel::Warning, "Process evaluation is not supported on this platform, evaluating with threads instead");
+		else
+		{
+			ProcessWorkers = std::make_shared<ProcessEvaluator>(this, Config->NumProcesses, Config->ProcessSlotSize);
+			if (!ProcessWorkers->Start()) ProcessWorkers = nullptr; // Fall back to thread evaluation
+		}
 	}
 
-	for (auto& Pairing : InitialPopulation)
+	if (!Config->SharedInnovations.empty() && !GetInnovations().Shared)
 	{
-		Population.Add(Pairing.GetChild());
+		if (!SharedInnovationTable::IsSupported()) LogMessage(LogLevel::Warning, "Shared innovations are not supported on this platform, numbering innovations in this process only");
+		else
+		{
+			auto Table = std::make_shared<SharedInnovationTable>(Config->SharedInnovations, Config->SharedInnovationCapacity);
+			if (Table->Open()) GetInnovations().Shared = Table; // Otherwise innovations are numbered in this process only
+		}
 	}
+	GetInnovations().Reset(Config->NumInputs + Config->NumOutputs + Config->NumHidden + 1); // Reset the innovation tracker, with the number of inputs, outputs, and hidden nodes, plus one for the bias node
+	InitialTopology::RegisterInnovations(Config); // Numbered once here, every initial genome copies the template
+	
+	Population = CreateGenomes(int(Config->PopulationSize)); // Create the initial population
 
 	LogMessage(LogLevel::Info, "Trainer initialized with population size: " + std::to_string(Population.Num()));
 	LogMessage(LogLevel::Info, "Starting training for " + std::to_string(Config->MaxGenerations) + " generations");
@@ -87,21 +257,116 @@ void NEAT::Trainer::EvaluatePopulation()
 
 void NEAT::Trainer::EvaluatePopulation() 
 {
-	if (Config->MultithreadedEvaluation)  // Multithreaded evaluation  
+	PrepareEarlyTermination();
+
+	EvaluationQueue = Population.FilterByPredicate([](const GenomePtr& Genome) { return !Genome->bEvaluated; });
+	const int NumPipelined = Population.Num() - EvaluationQueue.Num();
+	for (const auto& Genome : Population) // Offspring the reproduction pipeline evaluated keep their fitness, and tighten the early termination cutoffs right away
+	{
+		if (!Genome->bEvaluated) continue;
+		if (const auto* Cutoff = SpeciesCutoffs.Find(Genome->SpeciesID)) (*Cutoff)->Record(Genome->Fitness);
+	}
+
+	const int NumCandidates = EvaluationQueue.Num();
+	if (Cache) FilterCachedGenomes();
+
+	if (Config->DistributedEvaluation && Coordinator) // Distributed evaluation on remote workers
+	{
+		TArray<int> Unfinished;
+		if (!Coordinator->Evaluate(EvaluationQueue, Generation, Unfinished))
+		{
+			for (int Idx : Unfinished) // Evaluate locally whatever the workers couldn't
+			{
+				Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, Idx));
+				EvaluationQueue[Idx]->Fitness = EvaluateGenome(EvaluationQueue[Idx]);
+			}
+		}
+
+		if (Cache)
+		{
+			int NextUnfinished = 0; // Unfinished is in queue order, so it's walked alongside the queue
+			for (int Idx = 0, StopIdx = EvaluationQueue.Num(); Idx != StopIdx; ++Idx)
+			{
+				if (NextUnfinished != Unfinished.Num() && Unfinished[NextUnfinished] == Idx)
+				{
+					NextUnfinished++; // EvaluateGenome cached the local ones
+					continue;
+				}
+				Cache->Store(EvaluationQueue[Idx]->Genotype.GetFullHash(), EvaluationQueue[Idx]->Fitness);
+			}
+		}
+	}
+	else if (Config->ProcessEvaluation && ProcessWorkers) // Evaluation in forked worker processes
 	{
-		std::vector<std::thread> Threads;
-		for (int Idx = 0, StopIdx = Config->NumThreads; Idx != StopIdx; ++Idx)
+		ProcessWorkers->Evaluate(EvaluationQueue, Generation);
+		if (Cache)
 		{
-			Threads.emplace_back([this, Idx]() { EvaluatePopulationThread(Idx);	});
+			for (const auto& Genome : EvaluationQueue) Cache->Store(Genome->Genotype.GetFullHash(), Genome->Fitness);
 		}
+	}
+	else if (Config->AsyncEvaluation) // Coroutine evaluation with batched network queries
+	{
+		EvaluatePopulationAsync();
+	}
+	else // Local evaluation, on as many threads as the measured cost of the evaluation phase calls for
+	{
+		const ParallelPlan Plan = Tuner.Plan(*Config, EParallelPhase::Evaluation, EvaluationQueue.Num());
+		NextEvaluationIdx = 0;
+		const int FixedChunkSize = ParallelismTuner::PlanUnmeasured(*Config, EvaluationQueue.Num()).ChunkSize; // An overridden EvaluateBatch may share random draws across a batch, so its batches must not depend on timing
+		EvaluationChunkSize = Config->EvaluationBatchSize > 0 ? Config->EvaluationBatchSize : bPerGenomeBatches ? Plan.ChunkSize : FixedChunkSize;
+		EvaluationWorkNanoseconds = 0;
+
+		if (Plan.NumThreads > 1)
+		{
+			std::vector<std::thread> Threads;
+			for (int Idx = 0, StopIdx = Plan.NumThreads; Idx != StopIdx; ++Idx)
+			{
+				Threads.emplace_back([this, Idx, &Plan]()
+				{
+					ScopedContext BoundContext(Context.get());
+					Affinity::PinWorker(Config->ThreadAffinity, Idx, Plan.NumThreads); // Pinned workers with consecutive indices share a node
+					EvaluatePopulationThread(Idx);
+				});
+			}
+
+			for (auto& Thread : Threads) Thread.join();
+		}
+		else
+		{
+			EvaluatePopulationThread(0); // Single-threaded evaluation  
+		}
+
+		Tuner.Record(EParallelPhase::Evaluation, EvaluationQueue.Num(), EvaluationWorkNanoseconds);
+		if (Config->LogEvaluation)
+		{
+			LogMessage(LogLevel::Info, "Generation " + std::to_string(Generation) + ": evaluated " + std::to_string(EvaluationQueue.Num()) + " genomes on " + std::to_string(Plan.NumThreads) + " threads in chunks of " + std::to_string(EvaluationChunkSize));
+		}
+	}
+
+	for (const auto& Duplicate : CachedDuplicates) Duplicate.first->Fitness = Duplicate.second->Fitness; // Identical genomes of this generation share the fitness of the one evaluated
+
+	if (Config->LogEvaluation && NumEarlyTerminations > 0)
+	{
+		LogMessage(LogLevel::Info, "Generation " + std::to_string(Generation) + ": " + std::to_string(NumEarlyTerminations.load()) + " evaluations terminated early");
+	}
+
+	if (Config->LogEvaluation && Cache)
+	{
+		LogMessage(LogLevel::Info, "Generation " + std::to_string(Generation) + ": " + std::to_string(NumCandidates - EvaluationQueue.Num()) + " of " + std::to_string(Population.Num()) + " fitness values reused from the cache");
+	}
 
-		for (auto& Thread : Threads) Thread.join();
+	if (Config->LogEvaluation && NumPipelined > 0)
+	{
+		LogMessage(LogLevel::Info, "Generation " + std::to_string(Generation) + ": " + std::to_string(NumPipelined) + " offspring were evaluated by the reproduction pipeline");
 	}
-	else 
+
+	if (Config->LogEvaluation && Config->GenerationArena)
 	{
-		EvaluatePopulationThread(0); // Single-threaded evaluation  
+		LogMessage(LogLevel::Info, "Generation " + std::to_string(Generation) + ": " + std::to_string(GenerationArena::GetNumChunks()) + " arena chunks in use");
 	}
 
+	for (auto& Genome : Population) Genome->bEvaluated = false;
+
 	// Check for new best genome
 	for (auto& Genome : Population)
 	{
@@ -128,20 +393,247 @@ void NEAT::Trainer::EvaluatePopulation()
 
 void NEAT::Trainer::EvaluatePopulationThread(int ThreadID)
 {
-	int StartIdx = ThreadID * (Population.Num() / Config->NumThreads);
-	int EndIdx = (ThreadID + 1) * (Population.Num() / Config->NumThreads);
-	if (ThreadID == Config->NumThreads - 1) 
+	Benchmark::Timer WorkTimer("Evaluation", true);
+	const int NumGenomes = EvaluationQueue.Num();
+	const int BatchSize = Math::Max(EvaluationChunkSize, 1);
+	while (true) // Batches are claimed until the queue runs out, so threads that draw cheap genomes take on more of them
+	{
+		const int BatchIdx = NextEvaluationIdx.fetch_add(BatchSize);
+		if (BatchIdx >= NumGenomes) break;
+
+		const std::span<const GenomePtr> Batch(EvaluationQueue.GetData() + BatchIdx, Math::Min(BatchSize, NumGenomes - BatchIdx));
+		const uint64 NumEvaluated = NumGenomeEvaluations;
+		{
+			Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, BatchIdx)); // Setup shared by the batch draws from the stream of its first genome
+			CurrentBatchStart = BatchIdx;
+			EvaluateBatch(Batch);
+			CurrentBatchStart = 0;
+		}
+
+		if (NumGenomeEvaluations == NumEvaluated) // An overridden EvaluateBatch set the fitness values itself, record them like EvaluateGenome would
+		{
+			for (const auto& Genome : Batch)
+			{
+				EvaluationBounds Bounds; // Only for the species cutoff, the batch ran without early termination
+				BeginEvaluation(Genome, Bounds);
+				Genome->Fitness = FinishEvaluation(Genome, Bounds, Genome->Fitness);
+			}
+		}
+	}
+
+	EvaluationWorkNanoseconds += WorkTimer.GetNanosecondsElapsed();
+}
+
+void NEAT::Trainer::EvaluateBatch(std::span<const GenomePtr> Genomes)
+{
+	bPerGenomeBatches = true;
+	for (int Idx = 0, StopIdx = int(Genomes.size()); Idx != StopIdx; ++Idx)
 	{
-		EndIdx = Population.Num();
+		Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, CurrentBatchStart + Idx)); // Each genome draws from its own stream, so results don't depend on the thread count, batch size or scheduling
+		Genomes[Idx]->Fitness = EvaluateGenome(Genomes[Idx]);
 	}
+}
 
-	for (int Idx = StartIdx; Idx != EndIdx; ++Idx)
+// Sizes a survival cutoff for each species the same way ReproduceSpecies sizes its elitism culling, from the species IDs the genomes carry into evaluation.
+// Speciation runs after evaluation and may still move a genome to another species, so the bound is exact for genomes that keep their species
+void NEAT::Trainer::PrepareEarlyTermination()
+{
+	SpeciesCutoffs.Reset();
+	NumEarlyTerminations = 0;
+	if (!Config->EarlyTermination || Config->CullingMethod != ECullingMethod::Elitism) return;
+
+	TMap<uint64, int> SpeciesSizes;
+	for (const auto& Genome : Population)
+	{
+		if (Genome->SpeciesID != 0) SpeciesSizes[Genome->SpeciesID]++;
+	}
+
+	for (const auto& SizePair : SpeciesSizes)
+	{
+		const int SpeciesSize = SizePair.second;
+		if (SpeciesSize <= Config->MinSpeciesSize) continue; // Small species aren't culled
+
+		int NumSurvivors = Math::Floor<int>(SpeciesSize * Config->SurvivalRate);
+		if (NumSurvivors < Config->MinSpeciesSize) NumSurvivors = Config->MinSpeciesSize;
+		if (NumSurvivors > SpeciesSize - Config->SpeciesElitism) NumSurvivors = SpeciesSize - Config->SpeciesElitism;
+		if (NumSurvivors <= 0 || NumSurvivors >= SpeciesSize) continue;
+
+		auto Cutoff = std::make_shared<SpeciesCutoff>();
+		Cutoff->NumSurvivors = NumSurvivors;
+		SpeciesCutoffs[SizePair.first] = Cutoff;
+	}
+}
+
+double NEAT::Trainer::EvaluateGenome(const GenomePtr& Genome, bool bCacheResult)
+{
+	EvaluationBounds Bounds;
+	Bounds.bCacheable = bCacheResult;
+	BeginEvaluation(Genome, Bounds);
+	return EvaluateGenome(Genome, Bounds);
+}
+
+double NEAT::Trainer::EvaluateGenome(const GenomePtr& Genome, EvaluationBounds& Bounds)
+{
+	CurrentBounds = &Bounds;
+	const double Fitness = Evaluate(Genome);
+	CurrentBounds = nullptr;
+	NumGenomeEvaluations++;
+
+	return FinishEvaluation(Genome, Bounds, Fitness);
+}
+
+void NEAT::Trainer::BeginEvaluation(const GenomePtr& Genome, EvaluationBounds& Bounds) const
+{
+	const auto* Cutoff = Config->EarlyTermination ? SpeciesCutoffs.Find(Genome->SpeciesID) : nullptr;
+	Bounds.Cutoff = Cutoff ? Cutoff->get() : nullptr;
+	if (Config->EarlyTermination && Config->EarlyTerminationBelowBest && bHasBestGenome) Bounds.BestFitness = BestGenome.Fitness; // BestGenome is only updated once the whole population is evaluated
+}
+
+double NEAT::Trainer::FinishEvaluation(const GenomePtr& Genome, const EvaluationBounds& Bounds, double Fitness)
+{
+	if (Bounds.bTerminated) Fitness = Bounds.PartialFitness;
+	else if (Cache && Bounds.bCacheable) Cache->Store(Genome->Genotype.GetFullHash(), Fitness); // Partial fitness values aren't cached
+	if (Bounds.Cutoff) Bounds.Cutoff->Record(Fitness);
+	return Fitness;
+}
+
+NEAT::EvaluationTask NEAT::Trainer::EvaluateAsync(const GenomePtr& Genome)
+{
+	co_return Evaluate(Genome);
+}
+
+double NEAT::Trainer::EvaluateSynchronously(const GenomePtr& Genome)
+{
+	NeuralNetworkPtr Network = Genome->CreateNeuralNetwork();
+	EvaluationTask Task = EvaluateAsync(Genome);
+	while (Task.Resume())
+	{
+		Task.SetAction(Network->Evaluate(Task.GetObservation()));
+	}
+	return Task.GetFitness();
+}
+
+void NEAT::Trainer::EvaluatePopulationAsync()
+{
+	const int NumThreads = Config->MultithreadedEvaluation ? Math::Max(Math::Min(Config->GetNumThreads(), EvaluationQueue.Num()), 1) : 1;
+	std::atomic<int> NextIdx = 0;
+	if (NumThreads == 1)
+	{
+		EvaluatePopulationAsyncThread(NumThreads, NextIdx);
+		return;
+	}
+
+	std::vector<std::thread> Threads;
+	for (int Idx = 0; Idx != NumThreads; ++Idx)
+	{
+		Threads.emplace_back([this, Idx, NumThreads, &NextIdx]()
+		{
+			ScopedContext BoundContext(Context.get());
+			Affinity::PinWorker(Config->ThreadAffinity, Idx, NumThreads);
+			EvaluatePopulationAsyncThread(NumThreads, NextIdx);
+		});
+	}
+
+	for (auto& Thread : Threads) Thread.join();
+}
+
+// Keeps a share of Config->AsyncConcurrency evaluations in flight, taking genomes from EvaluationQueue as earlier ones finish.
+// Each step resumes every evaluation until its next network query, then answers all of the pending queries in one pass over the networks,
+// so the environment code and the network evaluation each run back to back instead of alternating for every genome
+void NEAT::Trainer::EvaluatePopulationAsyncThread(int NumThreads, std::atomic<int>& NextIdx)
+{
+	const int MaxInFlight = Math::Max(Config->AsyncConcurrency / NumThreads, 1);
+	TArray<std::shared_ptr<AsyncEvaluation>> InFlight;
+	InFlight.Reserve(MaxInFlight);
+
+	while (true)
+	{
+		while (InFlight.Num() < MaxInFlight)
+		{
+			const int Idx = NextIdx.fetch_add(1);
+			if (Idx >= EvaluationQueue.Num()) break;
+
+			auto Evaluation = std::make_shared<AsyncEvaluation>();
+			Evaluation->Genome = EvaluationQueue[Idx];
+			Evaluation->Network = Evaluation->Genome->CreateNeuralNetwork();
+			Evaluation->Stream.Seed(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Evaluation, Idx)); // The same stream EvaluatePopulationThread would bind
+			BeginEvaluation(Evaluation->Genome, Evaluation->Bounds);
+			Evaluation->Task = EvaluateAsync(Evaluation->Genome);
+			InFlight.Add(Evaluation);
+		}
+
+		if (InFlight.IsEmpty()) break;
+
+		for (const auto& Evaluation : InFlight)
+		{
+			Random::ScopedBinding Stream(Evaluation->Stream);
+			CurrentBounds = &Evaluation->Bounds;
+			Evaluation->Task.Resume();
+			CurrentBounds = nullptr;
+		}
+
+		for (const auto& Evaluation : InFlight)
+		{
+			if (!Evaluation->Task.IsDone()) Evaluation->Task.SetAction(Evaluation->Network->Evaluate(Evaluation->Task.GetObservation()));
+		}
+
+		InFlight.RemoveByPredicate([this](const std::shared_ptr<AsyncEvaluation>& Evaluation)
+		{
+			if (!Evaluation->Task.IsDone()) return false;
+			Evaluation->Genome->Fitness = FinishEvaluation(Evaluation->Genome, Evaluation->Bounds, Evaluation->Task.GetFitness());
+			return true;
+		});
+	}
+}
+
+// Leaves the genomes whose fitness is already known out of the evaluation queue: genomes found in the fitness cache get their cached fitness right away,
+// and genomes identical to one queued earlier in this generation copy its fitness once it's evaluated
+void NEAT::Trainer::FilterCachedGenomes()
+{
+	Cache->Trim(Generation);
+	const TArray<GenomePtr> Candidates = std::move(EvaluationQueue);
+	EvaluationQueue.Reset();
+	CachedDuplicates.Reset();
+
+	TMap<uint64, GenomePtr> Queued;
+	for (const auto& Genome : Candidates)
 	{
-		GenomePtr Genome = Population[Idx];
-		Genome->Fitness = Evaluate(Genome);
+		const uint64 Hash = Genome->Genotype.GetFullHash();
+		double CachedFitness = 0.0;
+		if (Cache->Find(Hash, CachedFitness))
+		{
+			Genome->Fitness = CachedFitness;
+			if (const auto* Cutoff = SpeciesCutoffs.Find(Genome->SpeciesID)) (*Cutoff)->Record(CachedFitness); // Cached elites tighten the early termination cutoffs right away
+			continue;
+		}
+
+		if (const GenomePtr* Original = Queued.Find(Hash))
+		{
+			CachedDuplicates.Add(std::make_pair(Genome, *Original));
+			continue;
+		}
+
+		Queued[Hash] = Genome;
+		EvaluationQueue.Add(Genome);
 	}
 }
 
+bool NEAT::Trainer::ReportPartialFitness(double PartialFitness, double UpperBound)
+{
+	EvaluationBounds* Bounds = CurrentBounds;
+	if (!Bounds) return true; // Not evaluated through EvaluateGenome, e.g. on a distributed or process worker
+	if (Bounds->bTerminated) return false;
+
+	double Threshold = Bounds->Cutoff ? Bounds->Cutoff->Threshold.load(std::memory_order_relaxed) : -std::numeric_limits<double>::max();
+	Threshold = Math::Max(Threshold, Bounds->BestFitness);
+	if (UpperBound >= Threshold) return true;
+
+	Bounds->PartialFitness = PartialFitness;
+	Bounds->bTerminated = true;
+	NumEarlyTerminations++;
+	return false;
+}
+
 // Checks for species that have stagnated
 void NEAT::Trainer::CheckForStagnation() 
 {
@@ -188,16 +680,7 @@ void NEAT::Trainer::CheckForStagnation()
 
 	if (Population.IsEmpty())
 	{
-		std::vector<GenomePairing::Offspring> InitialPopulation;
-		for (unsigned Idx = 0; Idx < Config->PopulationSize; ++Idx)
-		{
-			InitialPopulation.push_back(GenomePairing::Offspring(Config));
-		}
-
-		for (auto& Pairing : InitialPopulation)
-		{
-			Population.Add(Pairing.GetChild());
-		}
+		Population = CreateGenomes(int(Config->PopulationSize));
 	}
 }
 
@@ -234,31 +717,61 @@ void NEAT::Trainer::SpeciatePopulation_Method1()
 	DistanceCalculations = 0;
 	double DistanceSum = 0.0;
 
-	for (auto i = bNoSpecies ? 1 : 0; i < Population.Num(); ++i)
+	// Match the genomes against the species that existed before this pass in parallel. Those species come first in the first-match order,
+	// so a genome that matches one of them is assigned exactly where a serial pass would assign it
+	const int FirstIdx = bNoSpecies ? 1 : 0;
+	const int NumGenomes = Population.Num() - FirstIdx;
+	const TArray<SpeciesPtr> ExistingSpecies = Species;
+	TArray<TArray<double>> Distances; // The distances computed for each genome, up to its match
+	TArray<int> Matches;
+	Distances.SetNum(NumGenomes);
+	Matches.SetNum(NumGenomes, INDEX_NONE);
+
+	const ParallelPlan Plan = Tuner.Plan(*Config, EParallelPhase::Speciation, NumGenomes);
+	const uint64 WorkNanoseconds = ParallelFor(Plan, NumGenomes, Config->ThreadAffinity, [&](int StartIdx, int EndIdx)
 	{
-		auto& Genome = Population[i];
-		bool bSpeciesFound = false;
-		for (auto& Specie : Species)
+		for (int Idx = StartIdx; Idx != EndIdx; ++Idx)
 		{
-			double Distance = Distance::Calculate(Specie->Representative, Genome, Config);
-			DistanceSum += Distance;
-			DistanceCalculations++;
-			if (Distance < Config->SpeciationDistanceThreshold)
+			const GenomePtr& Genome = Population[FirstIdx + Idx];
+			for (int SpeciesIdx = 0, NumSpecies = ExistingSpecies.Num(); SpeciesIdx != NumSpecies; ++SpeciesIdx)
 			{
-				Specie->AddGenome(Genome);
-				Genome->SpeciesID = Specie->ID;
-				bSpeciesFound = true;
-				break;
+				const double Distance = Distance::Calculate(ExistingSpecies[SpeciesIdx]->Representative, Genome, Config);
+				Distances[Idx].Add(Distance);
+				if (Distance < Config->SpeciationDistanceThreshold)
+				{
+					Matches[Idx] = SpeciesIdx;
+					break;
+				}
 			}
 		}
+	});
+	Tuner.Record(EParallelPhase::Speciation, NumGenomes, WorkNanoseconds);
 
-		if (!bSpeciesFound)
+	// Assign in population order. Genomes that matched none of the old species are compared against the species founded earlier in this pass, or found a new one,
+	// so new species are created in the same order as in a serial pass
+	for (int Idx = 0; Idx != NumGenomes; ++Idx)
+	{
+		const GenomePtr& Genome = Population[FirstIdx + Idx];
+		for (double Distance : Distances[Idx]) DistanceSum += Distance;
+		DistanceCalculations += Distances[Idx].Num();
+
+		SpeciesPtr Match = Matches[Idx] != INDEX_NONE ? ExistingSpecies[Matches[Idx]] : nullptr;
+		for (int SpeciesIdx = ExistingSpecies.Num(), NumSpecies = Species.Num(); !Match && SpeciesIdx != NumSpecies; ++SpeciesIdx)
 		{
-			auto NewSpecies = std::make_shared<NEAT::Species>(Genome, Config);
-			NewSpecies->AddGenome(Genome);
-			Genome->SpeciesID = NewSpecies->ID;
-			Species.Add(NewSpecies);
+			const double Distance = Distance::Calculate(Species[SpeciesIdx]->Representative, Genome, Config);
+			DistanceSum += Distance;
+			DistanceCalculations++;
+			if (Distance < Config->SpeciationDistanceThreshold) Match = Species[SpeciesIdx];
+		}
+
+		if (!Match)
+		{
+			Match = std::make_shared<NEAT::Species>(Genome, Config);
+			Species.Add(Match);
 		}
+
+		Match->AddGenome(Genome);
+		Genome->SpeciesID = Match->ID;
 	}
 
 	AverageDistance = DistanceSum / DistanceCalculations;
@@ -338,9 +851,9 @@ void NEAT::Trainer::SpeciatePopulation_Method2()
 		if (Config->MultithreadedEvaluation)  // Multithreaded evaluation  
 		{
 			std::vector<std::thread> Threads;
-			for (int Idx = 1, StopIdx = Config->NumThreads; Idx != StopIdx; ++Idx)
+			for (int Idx = 0, StopIdx = Config->GetNumThreads(); Idx != StopIdx; ++Idx)
 			{
-				Threads.emplace_back([this, Idx]() { SpeciatePopulationThread(Idx);	});
+				Threads.emplace_back([this, Idx]() { ScopedContext BoundContext(Context.get()); SpeciatePopulationThread(Idx); });
 			}
 
 			for (auto& Thread : Threads) Thread.join();
@@ -355,16 +868,17 @@ void NEAT::Trainer::SpeciatePopulation_Method2()
 		ActiveSpecies.Reset(1); // Clear the ActiveSpecies list, it's not possible to match to any of the old species
 		if (!Unspeciated.IsEmpty())
 		{
-			Species.Add(std::make_shared<NEAT::Species>(Unspeciated[rand() % Unspeciated.Num()], Config)); // Create a new species for a random genome that was not assigned to a species
+			Species.Add(std::make_shared<NEAT::Species>(Unspeciated[GetRandomIndex(Unspeciated.Num())], Config)); // Create a new species for a random genome that was not assigned to a species
 		}
 	}
 }
 
 void NEAT::Trainer::SpeciatePopulationThread(int ThreadID)
 {
-	int StartIdx = ThreadID * (Unspeciated.Num() / Config->NumThreads);
-	int EndIdx = (ThreadID + 1) * (Unspeciated.Num() / Config->NumThreads);
-	if (ThreadID == Config->NumThreads - 1)
+	const int NumThreads = Config->GetNumThreads();
+	int StartIdx = ThreadID * (Unspeciated.Num() / NumThreads);
+	int EndIdx = (ThreadID + 1) * (Unspeciated.Num() / NumThreads);
+	if (ThreadID == NumThreads - 1)
 	{
 		EndIdx = Unspeciated.Num();
 	}
@@ -618,6 +1132,8 @@ void NEAT::Trainer::ReproduceSpecies()
 	}
 
 	// Generate offspring for the next generation
+	const bool bPipeline = CanPipelineOffspring();
+	TArray<std::pair<SpeciesPtr, GenomePairing::Offspring>> PendingOffspring;
 	for (auto& Specie : Species)
 	{
 		if (Specie->IsEmpty()) continue;
@@ -630,12 +1146,21 @@ void NEAT::Trainer::ReproduceSpecies()
 		TArray<GenomePairing::Offspring> Offspring = GenomePairing::Reproduce(Specie->Genomes, ReproductionCount, Config);
 		for (auto& Pairing : Offspring)
 		{
+			if (bPipeline)
+			{
+				PendingOffspring.Add(std::make_pair(Specie, Pairing)); // Bred once every parent is chosen
+				continue;
+			}
+
 			auto Child = Pairing.GetChild();
 			Child->SpeciesID  = Specie->ID;
 			Specie->AddGenome(Child);
 		}
 	}
 
+	Generation++;
+	if (bPipeline) RunOffspringPipeline(PendingOffspring); // Evaluated as members of the next generation
+
 	// Replace the old population with the new population
 	Population.Reset();
 	for (const auto& Specie : Species)
@@ -643,13 +1168,11 @@ void NEAT::Trainer::ReproduceSpecies()
 		Population.Append(Specie->Genomes);
 	}
 
-	Generation++;
-
 	int PopulationSize = Population.Num();
 	int IntendedSize = Config->PopulationSize;
 	if (Config->ReintroduceBestGenome && Generation % Config->ReintroductionPeriod == 0)
 	{
-		auto ReintroducedBest = std::make_shared<NEAT::Genome>(BestGenome);
+		auto ReintroducedBest = MakeArenaShared<NEAT::Genome>(BestGenome);
 		ReintroducedBest->ID = Genome::GenerateNewGenomeID();
 		ReintroducedBest->Config = Config;
 		ReintroducedBest->SpeciesID = 0;
@@ -663,37 +1186,117 @@ void NEAT::Trainer::MutateOffspring()
 	for (auto& Genome : Population)
 	{
 		if (Genome->bElite) continue; // Don't mutate the elites of each species
+		if (Genome->bEvaluated) continue; // The reproduction pipeline mutated it before evaluating it
 		if (Math::Random<double>(1.0) >= Config->MutationRate) continue; // Skip the mutation step if the mutation rate is not met
 		Genome->Genotype.Mutate(Config); // Check the Config->MutationRates to see if we should perform each type of mutation
 	}
 }
 
+bool NEAT::Trainer::CanPipelineOffspring() const
+{
+	return Config->PipelinedReproduction && !Config->SteadyStateEvolution && !Config->AsyncEvaluation && !(Config->DistributedEvaluation && Coordinator) && !(Config->ProcessEvaluation && ProcessWorkers);
+}
+
+// Runs one task per offspring that breeds it from its pairing, mutates it and evaluates it, so each child's genes are still in cache when its network is built and evaluated.
+// Mutations in the tasks number new innovations provisionally, on a tracker that extends the real one. Once the tasks are done the provisional innovations are numbered
+// for real in offspring order, so the innovation numbers, like the genome IDs and random streams, don't depend on the number of threads or the order the tasks finish in
+void NEAT::Trainer::RunOffspringPipeline(const TArray<std::pair<SpeciesPtr, GenomePairing::Offspring>>& Pending)
+{
+	const int NumOffspring = Pending.Num();
+	if (NumOffspring == 0) return;
+
+	TArray<GenomePtr> Children;
+	TArray<InnovationTracker> ProvisionalInnovations;
+	Children.SetNum(NumOffspring);
+	ProvisionalInnovations.SetNum(NumOffspring);
+
+	InnovationTracker& Tracker = GetInnovations();
+	SpeciesCutoffs.Reset(); // The cutoffs of the generation that was just culled don't apply to its offspring
+	const uint64 FirstID = Genome::ReserveGenomeIDs(uint64(NumOffspring)); // Numbered in offspring order, culling breaks fitness ties by ID
+
+	const ParallelPlan Plan = Tuner.Plan(*Config, EParallelPhase::Pipeline, NumOffspring);
+	const uint64 WorkNanoseconds = ParallelFor(Plan, NumOffspring, Config->ThreadAffinity, [&](int StartIdx, int EndIdx)
+	{
+		for (int Idx = StartIdx; Idx != EndIdx; ++Idx)
+		{
+			ProvisionalInnovations[Idx].Extend(Tracker);
+			ScopedInnovations BoundInnovations(ProvisionalInnovations[Idx]);
+			Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Pipeline, Idx)); // Breeding, mutation and evaluation of a child all draw from its own stream
+
+			GenomePtr Child = Pending[Idx].second.GetChild(FirstID + Idx);
+			Child->SpeciesID = Pending[Idx].first->ID;
+			Child->bElite = false;
+			if (Math::Random<double>(1.0) < Config->MutationRate) Child->Genotype.Mutate(Config);
+
+			// A child with provisional genes hashes differently than it will once they're renumbered, so it's neither looked up in the cache nor cached
+			const bool bFinalGenes = ProvisionalInnovations[Idx].Innovations.Num() == 0;
+			double CachedFitness = 0.0;
+			if (Cache && bFinalGenes && Cache->Find(Child->Genotype.GetFullHash(), CachedFitness)) Child->Fitness = CachedFitness;
+			else Child->Fitness = EvaluateGenome(Child, bFinalGenes);
+			Child->bEvaluated = true;
+			Children[Idx] = Child;
+		}
+	});
+	Tuner.Record(EParallelPhase::Pipeline, NumOffspring, WorkNanoseconds);
+
+	for (int Idx = 0; Idx != NumOffspring; ++Idx)
+	{
+		TMap<uint64, uint64> Remap;
+		for (const auto& InnovationPair : ProvisionalInnovations[Idx].Innovations) // Ordered by provisional ID, so an innovation is numbered after the nodes it refers to
+		{
+			const Innovation& Provisional = InnovationPair.second;
+			const uint64* Input = Remap.Find(Provisional.Input);
+			const uint64* Output = Remap.Find(Provisional.Output);
+			Remap[Provisional.ID] = Tracker.GetInnovationID(Provisional.MutationType, Provisional.GeneType, Input ? *Input : Provisional.Input, Output ? *Output : Provisional.Output);
+		}
+		Children[Idx]->Genotype.RemapGeneKeys(Remap);
+		Pending[Idx].first->AddGenome(Children[Idx]);
+	}
+}
+
 // Clones the genome and then mutates it, with a single original copy
 void NEAT::Trainer::RepopulateFromGenome(const GenomePtr& Genome) 
 {
+	ScopedContext BoundContext(Context.get());
+
     // Clone the genome
-    GenomePtr ClonedGenome = std::make_shared<NEAT::Genome>(*Genome);
+    GenomePtr ClonedGenome = MakeArenaShared<NEAT::Genome>(*Genome);
 
 	// Clear the population and add the cloned genome
 	Population.Reset();
 	Population.Add(ClonedGenome);
 
-	// Mutate the genome and fill out an Offspring list as if initializing from scratch
-	std::vector<GenomePairing::Offspring> InitialPopulation;
-	for (unsigned Idx = 0; Idx < Config->PopulationSize; ++Idx)
-	{
-		InitialPopulation.push_back(GenomePairing::Offspring(Config, ClonedGenome));
-	}
-
-	for (auto& Pairing : InitialPopulation)
-	{
-		Population.Add(Pairing.GetChild());
-	}
+	// Fill out the population with copies of the genome, as if initializing from scratch
+	Population.Append(CreateGenomes(int(Config->PopulationSize), ClonedGenome));
 
 	// Create the initial species
 	SpeciatePopulation();
 }
 
+// Builds genomes from Config defaults, or clones of Parent, in parallel
+TArray<NEAT::GenomePtr> NEAT::Trainer::CreateGenomes(int NumGenomes, const GenomePtr& Parent)
+{
+	TArray<GenomePtr> Genomes;
+	if (NumGenomes <= 0) return Genomes;
+	Genomes.SetNum(NumGenomes);
+
+	const uint64 FirstID = Genome::ReserveGenomeIDs(uint64(NumGenomes));
+	InnovationTracker& Tracker = GetInnovations(); // Workers read the initial topology template of the caller's tracker, which is an island's own tracker under the island model
+	const ParallelPlan Plan = Tuner.Plan(*Config, EParallelPhase::Initialization, NumGenomes);
+	const uint64 WorkNanoseconds = ParallelFor(Plan, NumGenomes, Config->ThreadAffinity, [&](int StartIdx, int EndIdx)
+	{
+		ScopedInnovations BoundInnovations(Tracker);
+		for (int Idx = StartIdx; Idx != EndIdx; ++Idx)
+		{
+			Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(Generation, Random::Initialization, Idx));
+			Genomes[Idx] = Parent ? InitialTopology::InitializeFromParent(Parent, FirstID + Idx) : InitialTopology::InitializeGenome(Config, FirstID + Idx);
+		}
+	});
+	Tuner.Record(EParallelPhase::Initialization, NumGenomes, WorkNanoseconds);
+
+	return Genomes;
+}
+
 // Clones the genome and then mutates it, with a single original copy
 void NEAT::Trainer::LoadPopulation(const std::string& Filename)
 {
@@ -707,7 +1310,7 @@ void NEAT::Trainer::LoadPopulation(const std::string& Filename)
     std::string SerializedGenome;
     while (std::getline(File, SerializedGenome))
     {
-        GenomePtr LoadedGenome = std::make_shared<NEAT::Genome>(Config);
+        GenomePtr LoadedGenome = MakeArenaShared<NEAT::Genome>(Config);
         if (!LoadedGenome->Genotype.Deserialize(SerializedGenome))
         {
             std::cout << "Failed to deserialize the genome." << std::endl;
@@ -749,7 +1352,7 @@ NEAT::GenomePtr NEAT::Trainer::LoadGenome(const std::string& Filename)
     std::string SerializedGenome;
     std::getline(File, SerializedGenome);
 
-    GenomePtr LoadedGenome = std::make_shared<NEAT::Genome>(Config);
+    GenomePtr LoadedGenome = MakeArenaShared<NEAT::Genome>(Config);
     if (!LoadedGenome->Genotype.Deserialize(SerializedGenome))
     {
         std::cout << "Failed to deserialize the genome." << std::endl;
@@ -800,6 +1403,25 @@ void NEAT::Trainer::SaveBestGenome() // Saves the best genome to a file, in a hu
 }
 
 void NEAT::Trainer::Train() // Runs the training loop until ShouldContinueTraining returns false  
+{
+	ScopedContext BoundContext(Context.get());
+	std::string PopulationMetadata = CreatePopulationMetadataFilename();
+
+	if (Config->SteadyStateEvolution)
+	{
+		TrainSteadyState(PopulationMetadata);
+		return;
+	}
+
+	Initialize();
+	while (ContinueTraining())
+	{
+		RunGeneration(PopulationMetadata);
+	}
+	GenerationTasks.WaitForBackground(); // The population info of the last generation is complete once training returns
+}
+
+std::string NEAT::Trainer::CreatePopulationMetadataFilename(const std::string& Suffix)
 {
 	// Create a unique filename with timestamp  
 	time_t now = time(0);
@@ -807,104 +1429,313 @@ void NEAT::Trainer::Train() // Runs the training loop until ShouldContinueTraini
 	localtime_s(&ltm, &now);
 	char timestamp[20];
 	strftime(timestamp, 20, "%Y%m%d_%H%M%S", &ltm);
-	std::string PopulationMetadata = "TrainingMetadata/population_info_" + std::string(timestamp) + ".json";
+	return "TrainingMetadata/population_info_" + std::string(timestamp) + Suffix + ".json";
+}
 
+// The phases run as a task graph. Each phase reads the whole population, so they form a chain, parallel within each phase; the population report and info are
+// captured as the generation goes and logged or written to disk on the background task, overlapping with the rest of the generation and the next one
+void NEAT::Trainer::RunGeneration(const std::string& PopulationMetadata) // Evaluates, speciates, reproduces and mutates the population once
+{
+	ScopedContext BoundContext(Context.get()); // Task graph and ParallelFor workers inherit it
+	GenerationArena::BeginGeneration(); // Offspring bred from here on go to fresh chunks
 	bool bLogTiming = false;
 
-	Initialize();
-	PopulationReporter PopReporter(this);
-	BestGenomeReporter BestReporter(this);
-	while (ContinueTraining())
+	const auto Evaluation = GenerationTasks.Add("Evaluation", [this]()
 	{
 		Benchmark::Timer EvaluationTimer("Evaluation", Config->LogEvaluation);
 		EvaluatePopulation();
 		EvaluationTimer.Stop(Config->LogEvaluation);
+	});
 
+	const auto Stagnation = GenerationTasks.Add("Stagnation", [this, bLogTiming]()
+	{
 		Benchmark::Timer StagnationTimer("Stagnation", bLogTiming);
 		CheckForStagnation();
 		StagnationTimer.Stop(bLogTiming);
+	}, { Evaluation });
 
+	const auto Speciation = GenerationTasks.Add("Speciation", [this, bLogTiming]()
+	{
 		Benchmark::Timer SpeciateTimer("Speciate", bLogTiming);
 		SpeciatePopulation();
 		SpeciateTimer.Stop(bLogTiming);
+	}, { Stagnation });
 
-		if (Generation % 100 == 0) PopReporter.Report();
-		//if (Generation % 10 == 0) BestReporter.Report();
+	// The report copies the species before they are culled, which is cheap, and computes and logs the distances on the background task while the generation goes on
+	TaskGraph::TaskID CaptureReport = Speciation;
+	if (Generation % 100 == 0)
+	{
+		auto Reporter = std::make_shared<std::unique_ptr<PopulationReporter>>();
+		CaptureReport = GenerationTasks.Add("CaptureReport", [this, Reporter]() { *Reporter = std::make_unique<PopulationReporter>(this); }, { Speciation });
+		GenerationTasks.AddBackground("Report", [Reporter]() { (*Reporter)->Report(); }, { CaptureReport });
+	}
+	//if (Generation % 10 == 0) BestGenomeReporter(this).Report();
 
+	const auto Reproduction = GenerationTasks.Add("Reproduction", [this, bLogTiming]()
+	{
 		Benchmark::Timer ReproduceTimer("Reproduce", bLogTiming);
 		ReproduceSpecies();
 		ReproduceTimer.Stop(bLogTiming);
+	}, { Speciation, CaptureReport });
 
+	const auto Mutation = GenerationTasks.Add("Mutation", [this, bLogTiming]()
+	{
 		Benchmark::Timer MutateTimer("Mutate", bLogTiming);
 		MutateOffspring();
 		MutateTimer.Stop(bLogTiming);
+	}, { Reproduction });
 
-		/*if (Generation % 10 == 0)*/ SerializePopulationInfo(PopulationMetadata);
-	}
+	/*if (Generation % 10 == 0)*/
+	auto Info = std::make_shared<PopulationInfo>();
+	const auto Capture = GenerationTasks.Add("CapturePopulationInfo", [this, Info]() { *Info = CapturePopulationInfo(Species); }, { Mutation });
+	GenerationTasks.AddBackground("SerializePopulationInfo", [PopulationMetadata, Info]() { WritePopulationInfo(PopulationMetadata, *Info); }, { Capture });
+
+	GenerationTasks.Run(1);
 }
 
-NEAT::SpeciesPtr NEAT::Trainer::GetSpeciesByID(uint64 ID) const // Returns the species with the given ID
+// Runs real-time (rtNEAT-style) evolution: the initial population is evaluated and speciated once, then worker threads repeatedly breed a single offspring,
+// evaluate it outside the lock, and insert it in place of a low-ranked genome. Species bookkeeping is updated per insertion, so there is no generation barrier
+void NEAT::Trainer::TrainSteadyState(const std::string& PopulationMetadata)
 {
-	for (const auto& Specie : Species)
+	ScopedContext BoundContext(Context.get());
+	Initialize();
+	EvaluatePopulation();
+	SpeciesCutoffs.Reset(); // Survival cutoffs only apply to generational culling, offspring are only bounded by the best genome
+	SpeciatePopulation();
+	UpdateReproductionCounts();
+	for (auto& Specie : Species) UpdateSpeciesAdjustedFitness(Specie);
+	SteadyStateInsertions = 0;
+
+	int NumWorkers = Config->MultithreadedEvaluation ? Config->GetNumThreads() : 1;
+	std::vector<std::thread> Threads;
+	for (int Idx = 0; Idx != NumWorkers; ++Idx)
 	{
-		if (Specie->ID == ID) return Specie;
+		Threads.emplace_back([this, Idx, NumWorkers, &PopulationMetadata]()
+		{
+			ScopedContext BoundContext(Context.get());
+			Affinity::PinWorker(Config->ThreadAffinity, Idx, NumWorkers);
+			SteadyStateThread(Idx, PopulationMetadata);
+		});
 	}
-	return nullptr;
+
+	for (auto& Thread : Threads) Thread.join();
+	GenerationTasks.WaitForBackground(); // The reports and population info of the last generation are complete once training returns
 }
 
-NEAT::GenomePtr NEAT::Trainer::GetGenomeByID(uint64 ID) const // Returns the genome with the given ID
+void NEAT::Trainer::SteadyStateThread(int ThreadID, const std::string& PopulationMetadata)
 {
-	for (const auto& Genome : Population)
+	Random::ScopedStream Stream(Config->RandomSeed, Random::MakeStreamID(0, Random::SteadyState, ThreadID));
+	while (true)
 	{
-		if (Genome->ID == ID) return Genome;
+		GenomePtr Offspring = nullptr;
+		EvaluationBounds Bounds;
+		{
+			std::lock_guard<std::mutex> Lock(SteadyStateMutex);
+			if (!ContinueTraining()) return;
+			Offspring = BreedSteadyStateOffspring();
+			BeginEvaluation(Offspring, Bounds); // The best genome it bounds the evaluation by changes as offspring are inserted
+		}
+
+		// The offspring isn't shared yet, so the expensive evaluation runs without holding the lock. One genome is evaluated at a time, EvaluateBatch isn't used
+		double CachedFitness = 0.0;
+		if (Cache && Cache->Find(Offspring->Genotype.GetFullHash(), CachedFitness)) Offspring->Fitness = CachedFitness;
+		else Offspring->Fitness = EvaluateGenome(Offspring, Bounds);
+
+		std::lock_guard<std::mutex> Lock(SteadyStateMutex);
+		if (InsertSteadyStateOffspring(Offspring)) AdvanceSteadyStateGeneration(PopulationMetadata);
 	}
-	return nullptr;
 }
 
-void NEAT::Trainer::SerializePopulationInfo(const std::string& Filename)
+NEAT::GenomePtr NEAT::Trainer::BreedSteadyStateOffspring()
 {
-	std::time_t Timestamp = std::time(0); // Get the current timestamp
+	// Only non-stagnant species may breed, unless every species has stagnated
+	TArray<SpeciesPtr> Candidates = Species.FilterByPredicate([](const SpeciesPtr& Specie) { return !Specie->IsEmpty() && !Specie->IsStagnant; });
+	if (Candidates.IsEmpty()) Candidates = Species.FilterByPredicate([](const SpeciesPtr& Specie) { return !Specie->IsEmpty(); });
+	if (Candidates.IsEmpty()) return GenomePairing::Offspring(Config).GetChild();
+
+	// Roulette selection of the parent species by adjusted fitness, shifted to be positive so that the weakest species still has a small chance
+	double MinAdjustedFitness = Candidates[0]->AdjustedFitness;
+	for (const auto& Specie : Candidates) MinAdjustedFitness = Math::Min(MinAdjustedFitness, Specie->AdjustedFitness);
+
+	TArray<double> Weights;
+	double TotalWeight = 0.0;
+	for (const auto& Specie : Candidates)
+	{
+		Weights.Add(Specie->AdjustedFitness - MinAdjustedFitness + 1e-6);
+		TotalWeight += Weights.Last();
+	}
 
-	// Check if the file is empty  
-	std::ifstream CheckFile(Filename);
-	bool isEmpty = CheckFile.peek() == std::ifstream::traits_type::eof();
-	CheckFile.close();
+	SpeciesPtr ParentSpecies = Candidates.Last();
+	double Selection = GetRandomDouble(0.0, TotalWeight);
+	for (int Idx = 0, StopIdx = Candidates.Num(); Idx != StopIdx; ++Idx)
+	{
+		Selection -= Weights[Idx];
+		if (Selection > 0.0) continue;
+		ParentSpecies = Candidates[Idx];
+		break;
+	}
+
+	TArray<GenomePairing::Offspring> Pairings = GenomePairing::Reproduce(ParentSpecies->Genomes, 1, Config);
+	GenomePtr Child = Pairings.IsEmpty() ? GenomePairing::Offspring(Config, ParentSpecies->GetRandomGenome()).GetChild() : Pairings[0].GetChild();
+	Child->bElite = false;
+	if (Math::Random<double>(1.0) < Config->MutationRate) Child->Genotype.Mutate(Config);
+	return Child;
+}
 
-	if (isEmpty)
+bool NEAT::Trainer::InsertSteadyStateOffspring(const GenomePtr& Offspring)
+{
+	// Assign the offspring to the first compatible species, or found a new species for it
+	SpeciesPtr TargetSpecies = nullptr;
+	for (auto& Specie : Species)
 	{
-		// Create the file and any necessary folders that don't already exist, without filesystem  
-		std::ofstream File(Filename, std::ios_base::app);
-		if (!File.is_open()) return;
+		if (!Specie->Representative) continue;
+		if (Distance::Calculate(Specie->Representative, Offspring, Config) >= Config->SpeciationDistanceThreshold) continue;
+		TargetSpecies = Specie;
+		break;
+	}
 
-		File << "["; // If empty, add a "[" to the beginning of the file
-		// Serialize the population info to the file in JSON format
-		File << "{\"timestamp\": " << Timestamp << ", \"species\": [" << std::endl;
-		auto LastSpecies = Species.Last();
-		for (const auto& Specie : Species)
+	// Choose the genome to replace: the weakest member of the offspring's species once it has reached its share of the population,
+	// otherwise the genome with the lowest adjusted fitness, preferring stagnant species and never removing a species' best genome
+	GenomePtr Victim = nullptr;
+	SpeciesPtr VictimSpecies = nullptr;
+	if (Population.Num() >= int(Config->PopulationSize))
+	{
+		if (TargetSpecies && TargetSpecies->GetNum() >= Math::Max(TargetSpecies->DesiredPopulationSize, Config->MinSpeciesSize))
+		{
+			for (const auto& Genome : TargetSpecies->Genomes)
+			{
+				if (!Victim || Genome->Fitness < Victim->Fitness) Victim = Genome;
+			}
+			VictimSpecies = TargetSpecies;
+		}
+		else
 		{
-			File << "  {\"id\": " << Specie->ID << ", \"size\": " << Specie->Genomes.Num() << ", \"stagnation\": " << Specie->Stagnation << ", \"adjusted_fitness\": " << Specie->AdjustedFitness << "}";
-			if (Specie == LastSpecies) File << std::endl;
-			else File << "," << std::endl;
+			bool bVictimStagnant = false;
+			double VictimFitness = 0.0;
+			for (const auto& Specie : Species)
+			{
+				if (Specie->GetNum() <= 1 && !Specie->IsStagnant) continue;
+				GenomePtr SpecieBest = Specie->IsStagnant ? nullptr : Specie->GetBestGenome();
+				for (const auto& Genome : Specie->Genomes)
+				{
+					if (Genome == SpecieBest) continue;
+					double AdjustedFitness = Genome->Fitness / Specie->GetNum();
+					bool bBetterVictim = !Victim || (Specie->IsStagnant && !bVictimStagnant) || (Specie->IsStagnant == bVictimStagnant && AdjustedFitness < VictimFitness);
+					if (!bBetterVictim) continue;
+					Victim = Genome;
+					VictimSpecies = Specie;
+					VictimFitness = AdjustedFitness;
+					bVictimStagnant = Specie->IsStagnant;
+				}
+			}
 		}
-		File << "]}]";
-		File.close(); // Add this line to close the file and release memory
 	}
-	else
+
+	if (!TargetSpecies)
+	{
+		TargetSpecies = std::make_shared<NEAT::Species>(Offspring, Config);
+		TargetSpecies->DesiredPopulationSize = Config->MinSpeciesSize;
+		Species.Add(TargetSpecies);
+	}
+
+	Offspring->SpeciesID = TargetSpecies->ID;
+	TargetSpecies->AddGenome(Offspring);
+	Population.Add(Offspring);
+
+	if (Victim)
+	{
+		VictimSpecies->RemoveGenome(Victim);
+		Population.Remove(Victim);
+		if (VictimSpecies->IsEmpty()) Species.Remove(VictimSpecies);
+		else if (VictimSpecies != TargetSpecies) UpdateSpeciesAdjustedFitness(VictimSpecies);
+	}
+	UpdateSpeciesAdjustedFitness(TargetSpecies);
+
+	if (!bHasBestGenome || Offspring->Fitness > BestGenome.Fitness)
 	{
-		// If not empty, remove the last "]" and add a ","  
-		std::fstream File(Filename, std::ios_base::in | std::ios_base::out);
-		File.seekg(-1, std::ios_base::end);
-		File << "," << std::endl;
-		// Serialize the population info to the file in JSON format
-		File << "{\"timestamp\": " << Timestamp << ", \"species\": [" << std::endl;
-		auto LastSpecies = Species.Last();
-		for (const auto& Specie : Species)
+		BestGenome = *Offspring;
+		BestGenome.Config = Config;
+		bHasBestGenome = true;
+		NEAT::NewBestGenomeReporter NewBestGenomeReporter(Offspring, Generation);
+		NewBestGenomeReporter.Report();
+	}
+
+	int GenerationLength = Config->SteadyStateGenerationLength > 0 ? Config->SteadyStateGenerationLength : int(Config->PopulationSize);
+	return ++SteadyStateInsertions % GenerationLength == 0;
+}
+
+void NEAT::Trainer::AdvanceSteadyStateGeneration(const std::string& PopulationMetadata)
+{
+	Generation++;
+	GenerationArena::BeginGeneration();
+
+	for (auto& Specie : Species)
+	{
+		if (Specie->AdjustedFitness > Specie->BestAdjustedFitness)
+		{
+			Specie->BestAdjustedFitness = Specie->AdjustedFitness;
+			Specie->Stagnation = 0;
+		}
+		else if (++Specie->Stagnation >= Config->MaxStagnation)
+		{
+			Specie->IsStagnant = true; // Stagnant species stop breeding and are replaced first, until they die out
+		}
+
+		if (!Specie->IsEmpty())
 		{
-			File << "  {\"id\": " << Specie->ID << ", \"size\": " << Specie->Genomes.Num() << ", \"stagnation\": " << Specie->Stagnation << ", \"adjusted_fitness\": " << Specie->AdjustedFitness << "}";
-			if (Specie == LastSpecies) File << std::endl;
-			else File << "," << std::endl;
+			Specie->Representative = Config->ChooseBestRepresentative ? Specie->GetBestGenome() : Specie->GetRandomGenome();
 		}
-		File << "]}]";
-		File.close(); // Add this line to close the file and release memory
 	}
+
+	UpdateReproductionCounts();
+	for (auto& Specie : Species) UpdateSpeciesAdjustedFitness(Specie); // Reproduction counts shift the adjusted fitness, restore the plain values
+
+	if (Cache) Cache->Trim(Generation);
+
+	// The report and population info are captured under the lock, then logged and written on the background task so that the other workers aren't held up
+	if (Generation % 100 == 0)
+	{
+		auto Reporter = std::make_shared<PopulationReporter>(this);
+		GenerationTasks.AddBackground("Report", [Reporter]() { Reporter->Report(); });
+	}
+	auto Info = std::make_shared<PopulationInfo>(CapturePopulationInfo(Species));
+	GenerationTasks.AddBackground("SerializePopulationInfo", [PopulationMetadata, Info]() { WritePopulationInfo(PopulationMetadata, *Info); });
+	GenerationTasks.Run(1); // Only queues the background tasks
+}
+
+void NEAT::Trainer::UpdateSpeciesAdjustedFitness(const SpeciesPtr& Specie)
+{
+	Specie->AdjustedFitness = 0.0;
+	for (const auto& Genome : Specie->Genomes)
+	{
+		Specie->AdjustedFitness += Genome->Fitness / Specie->Genomes.Num();
+	}
+}
+
+int NEAT::Trainer::RunWorker(const std::string& Host, int Port) // Runs this process as a distributed evaluation worker
+{
+	return Distributed::RunWorker(*this, Host, Port);
+}
+
+NEAT::SpeciesPtr NEAT::Trainer::GetSpeciesByID(uint64 ID) const // Returns the species with the given ID
+{
+	for (const auto& Specie : Species)
+	{
+		if (Specie->ID == ID) return Specie;
+	}
+	return nullptr;
+}
+
+NEAT::GenomePtr NEAT::Trainer::GetGenomeByID(uint64 ID) const // Returns the genome with the given ID
+{
+	for (const auto& Genome : Population)
+	{
+		if (Genome->ID == ID) return Genome;
+	}
+	return nullptr;
+}
+
+void NEAT::Trainer::SerializePopulationInfo(const std::string& Filename)
+{
+	WritePopulationInfo(Filename, CapturePopulationInfo(Species));
 }
\ No newline at end of file
@@ -3,8 +3,15 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <mutex>
+#include <atomic>
+#include <span>
 #include "Types.h"
 #include "Genome.h"
+#include "EvolutionContext.h"
+#include "EvaluationTask.h"
+#include "Parallelism.h"
+#include "TaskGraph.h"
 
 namespace NEAT
 {
@@ -18,6 +25,10 @@ namespace NEAT
 	class Genome;
 	using GenomePtr = std::shared_ptr<NEAT::Genome>;
 
+	namespace Distributed { class Coordinator; }
+	class ProcessEvaluator;
+	class FitnessCache;
+
 	class Trainer
 	{
 	public:
@@ -45,17 +56,44 @@ namespace NEAT
 		void SpeciatePopulation_Method2();
 
 		void EvaluatePopulationThread(int ThreadID);
+		void EvaluatePopulationAsyncThread(int NumThreads, std::atomic<int>& NextIdx); // Claims genomes from EvaluationQueue through NextIdx, NumThreads threads share Config->AsyncConcurrency
 		void SpeciatePopulationThread(int ThreadID);
 
 		virtual double Evaluate(const GenomePtr& Genome) = 0; // Evaluates the fitness of a single genome
+		virtual void EvaluateBatch(std::span<const GenomePtr> Genomes); // Evaluates a batch of the population and sets each genome's Fitness, see Config->EvaluationBatchSize. The default calls Evaluate for each genome. Overrides can share setup such as datasets across the batch, they don't take part in early termination
+		virtual EvaluationTask EvaluateAsync(const GenomePtr& Genome); // Evaluates the fitness of a single genome as a coroutine that yields its network queries, see EvaluationTask.h. The default calls Evaluate without querying
+		double EvaluateSynchronously(const GenomePtr& Genome); // Runs EvaluateAsync to the end on the calling thread, answering each query right away. Trainers written against EvaluateAsync can implement Evaluate with it, for the evaluation modes that call Evaluate
+		void EvaluatePopulationAsync(); // Evaluates EvaluationQueue through EvaluateAsync, see Config->AsyncEvaluation
+		bool ReportPartialFitness(double PartialFitness, double UpperBound); // Called by Evaluate as it progresses, with the fitness so far and an optimistic bound on the final fitness. Returns false once the genome provably can't survive culling (see Config->EarlyTermination), Evaluate should then return early and the genome is given the reported partial fitness
+		double EvaluateGenome(const GenomePtr& Genome, bool bCacheResult = true); // Calls Evaluate, bounded by the survival cutoff of the genome's species when early termination is enabled, and caches the result when fitness caching is enabled and bCacheResult is set
+		struct EvaluationBounds; // The early termination state of one running evaluation, defined in Trainer.cpp
+		void BeginEvaluation(const GenomePtr& Genome, EvaluationBounds& Bounds) const; // Sets up the early termination bounds of an evaluation that is about to start
+		double EvaluateGenome(const GenomePtr& Genome, EvaluationBounds& Bounds); // Calls Evaluate within bounds set up by BeginEvaluation, for callers that have to set them up under a lock
+		double FinishEvaluation(const GenomePtr& Genome, const EvaluationBounds& Bounds, double Fitness); // Returns the fitness the genome is given once its evaluation ended, and records it for early termination and fitness caching
+		void PrepareEarlyTermination(); // Sizes the per-species survival cutoffs for the population that is about to be evaluated
+		void FilterCachedGenomes(); // Removes the genomes whose fitness is cached from EvaluationQueue, see Config->FitnessCaching
+		bool CanPipelineOffspring() const; // Whether offspring are bred, mutated and evaluated in one task, see Config->PipelinedReproduction
+		void RunOffspringPipeline(const TArray<std::pair<SpeciesPtr, GenomePairing::Offspring>>& Pending); // Breeds, mutates and evaluates each pending offspring in one task, then adds them to their species in order
 
 		void RepopulateFromGenome(const GenomePtr& Genome); // Clones the genome and then mutates it, with a single original copy
+		TArray<GenomePtr> CreateGenomes(int NumGenomes, const GenomePtr& Parent = nullptr); // Builds genomes from Config defaults, or clones of Parent, in parallel. Each gets its own random stream and an ID in order, so the result doesn't depend on the number of threads
 		void LoadPopulation(const std::string& Filename); // Loads the entire population from a file, in a human-readable format that was saved earlier
 		void SavePopulation(const std::string& Filename); // Saves the entire population to a file, in a human-readable format that can also be read back in later
 		void SaveGenome(const std::string& Filename, const GenomePtr& Genome); // Serializes the genome to a file, in a human-readable format that can also be read back in later
 		GenomePtr LoadGenome(const std::string& Filename); // Deserializes the genome from a file, in a human-readable format that was saved earlier
 		void SaveBestGenome(); // Saves the best genome to a file, in a human-readable format that can also be read back in later
 		void Train(); // Runs the training loop until ShouldContinueTraining returns false
+		void RunGeneration(const std::string& PopulationMetadata); // Runs a single generation of the training loop: evaluation, stagnation, speciation, reproduction and mutation
+		static std::string CreatePopulationMetadataFilename(const std::string& Suffix = ""); // Returns a timestamped filename for SerializePopulationInfo
+		void TrainSteadyState(const std::string& PopulationMetadata); // Runs real-time evolution until ShouldContinueTraining returns false, with worker threads breeding, evaluating and inserting single offspring without generation barriers
+
+		int RunWorker(const std::string& Host, int Port); // Runs this process as a distributed evaluation worker for the coordinator at Host:Port, see Distributed.h
+
+		void SteadyStateThread(int ThreadID, const std::string& PopulationMetadata);
+		GenomePtr BreedSteadyStateOffspring(); // Breeds and mutates a single offspring from a species chosen by adjusted fitness, requires SteadyStateMutex
+		bool InsertSteadyStateOffspring(const GenomePtr& Offspring); // Speciates an evaluated offspring and replaces a low-ranked genome with it, returns true when a steady-state generation completed, requires SteadyStateMutex
+		void AdvanceSteadyStateGeneration(const std::string& PopulationMetadata); // Updates stagnation, representatives and reproduction counts once per steady-state generation, requires SteadyStateMutex
+		void UpdateSpeciesAdjustedFitness(const SpeciesPtr& Specie); // Recalculates the adjusted fitness of a single species from its current members
 
 		SpeciesPtr GetSpeciesByID(uint64 ID) const; // Returns the species with the given ID
 		GenomePtr GetGenomeByID(uint64 ID) const; // Returns the genome with the given ID
@@ -69,8 +107,30 @@ namespace NEAT
 		bool bHasBestGenome = false;
 		NEAT::Genome BestGenome;
 		ConfigPtr Config = nullptr;
+		EvolutionContextPtr Context = std::make_shared<EvolutionContext>(); // The innovation tracker and ID counters of this trainer, bound to its threads by Initialize, Train, RunGeneration and the threads they start. Trainers may share one to evolve a common gene pool
 		unsigned Generation = 0;
 		double AverageDistance = 0.0;
 		double DistanceCalculations = 0;
+
+		std::shared_ptr<Distributed::Coordinator> Coordinator = nullptr; // Only used for distributed evaluation
+		std::shared_ptr<ProcessEvaluator> ProcessWorkers = nullptr; // Only used for process evaluation
+		std::shared_ptr<FitnessCache> Cache = nullptr; // Only used for fitness caching
+
+		TArray<GenomePtr> EvaluationQueue; // The genomes evaluated this generation, the whole population unless fitness caching is enabled
+		std::atomic<int> NextEvaluationIdx = 0; // The next EvaluationQueue index an evaluation thread claims a batch at
+		int EvaluationChunkSize = 1; // The number of genomes an evaluation thread claims at a time
+		std::atomic<bool> bPerGenomeBatches = false; // Set once the default EvaluateBatch ran, whose results don't depend on the batch boundaries, so the batches can follow the measured chunk size
+		std::atomic<uint64> EvaluationWorkNanoseconds = 0; // Time spent evaluating this generation, summed over the evaluation threads
+
+		ParallelismTuner Tuner; // Measures the parallel phases and sizes their next run, see Config->AdaptiveParallelism
+		TaskGraph GenerationTasks; // Runs the phases of RunGeneration in dependency order, and the population reports and info writes that trail them in the background
+		TArray<std::pair<GenomePtr, GenomePtr>> CachedDuplicates; // Only used for fitness caching, genomes paired with the identical queued genome they take their fitness from
+
+		struct SpeciesCutoff; // The best fitness values completed so far in one species, defined in Trainer.cpp
+		TMap<uint64, std::shared_ptr<SpeciesCutoff>> SpeciesCutoffs; // Only used for early termination, read-only while the population is evaluated
+		std::atomic<uint64> NumEarlyTerminations = 0;
+
+		std::mutex SteadyStateMutex; // Guards the population, species and innovations while training in steady-state mode
+		uint64 SteadyStateInsertions = 0;
 	};
 }
\ No newline at end of file
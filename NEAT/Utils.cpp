@@ -3,25 +3,33 @@
 #include <fstream>  
 #include <string>  
 #include <cstdlib>
+#include "Random.h"
 
 namespace NEAT
 {
-	// Initialize random seed  
+	// Initialize random seed, reseeding the calling thread's stream (worker threads bind their own streams derived from the same seed)
 	void InitializeRandomSeed(unsigned Seed /*= 0*/)
 	{
-		srand(static_cast<unsigned>(Seed));
+		Random::GetBaseSeed() = Seed;
+		Random::GetThreadStream().Seed(Seed, 0);
 	}
 
 	// Generate random integer  
 	int GetRandomInt(int Min, int Max)
 	{
-		return (rand() % (Max - Min + 1)) + Min;
+		return Random::GetStream().NextInt(Min, Max);
 	}
 
 	// Generate random float  
 	double GetRandomDouble(double Min, double Max)
 	{
-		return (double)rand() / RAND_MAX * (Max - Min) + Min;
+		return Random::GetStream().NextDouble(Min, Max);
+	}
+
+	// Generate random index
+	int GetRandomIndex(int Num)
+	{
+		return Random::GetStream().NextIndex(Num);
 	}
 
 	// Log message  
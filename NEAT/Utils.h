@@ -6,6 +6,9 @@
 #include <vector>  
 #include <random>
 #include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include "Types.h"
 
 #define BREAKPOINT() __debugbreak()
 
@@ -37,6 +40,7 @@ namespace NEAT
 	void InitializeRandomSeed(unsigned Seed = 0); // Initialize random seed  
 	int GetRandomInt(int Min, int Max); // Generate random integer  
 	double GetRandomDouble(double Min, double Max); // Generate random double  
+	int GetRandomIndex(int Num); // Generate random index in [0, Num)
 
 	void LogMessage(LogLevel Level, const std::string& Message, bool bSaveToLog = false); // Log message to file  
 	void LogMessage(LogLevel Level, const std::string& Message, const std::string& Filename); // Log message to file with filename  
@@ -51,6 +55,27 @@ namespace NEAT
 	}
 
 
+	// Appends the raw bytes of a trivially copyable value to a binary buffer. The binary encodings built on this are only meant for transfer between processes of the same build and architecture
+	template<typename T>
+	inline void WriteBinary(std::vector<uint8>& Buffer, const T& Value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "WriteBinary requires a trivially copyable type");
+		size_t Offset = Buffer.size();
+		Buffer.resize(Offset + sizeof(T));
+		std::memcpy(Buffer.data() + Offset, &Value, sizeof(T));
+	}
+
+	// Reads a value written by WriteBinary and advances Offset, returns false if the buffer is too short
+	template<typename T>
+	inline bool ReadBinary(const uint8* Data, size_t Size, size_t& Offset, T& OutValue)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ReadBinary requires a trivially copyable type");
+		if (Offset + sizeof(T) > Size) return false;
+		std::memcpy(&OutValue, Data + Offset, sizeof(T));
+		Offset += sizeof(T);
+		return true;
+	}
+
 	//void PrintGenome(const Genome& Genome); // Print genome to console  
 	//void PrintNeuralNetwork(const NeuralNetwork& Network); // Print neural network to console  
 	//void PrintPopulation(const Population& Agents); // Print population to console
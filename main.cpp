@@ -11,6 +11,7 @@ int main()
 	//auto Trainer = XORTrainer(Config);
 	//auto Trainer = XANDTrainer(Config);
 	auto Trainer = DotProductTrainer(Config);
+	//auto Trainer = CartPoleTrainer(Config); // Config->AsyncEvaluation = true; steps the episodes as coroutines with batched network queries
 
 	//auto Trainer = BuySellStockTrainer(Config);
 	//Trainer.RawPriceDataFilepath = "C:/Users/gmv00/source/repos/ForexBot/stock_daily/HAL_daily_json.csv";
@@ -21,6 +22,9 @@ int main()
 	Config->NumInputs = Trainer.GetNumInputs();
 	Config->NumOutputs = Trainer.GetNumOutputs();
 
+	//NEAT::IslandModel Islands(Config, [](const NEAT::ConfigPtr& IslandConfig) { return std::make_shared<DotProductTrainer>(IslandConfig); });
+	//Islands.Train();
+
 	Trainer.Train();
 	Trainer.Report();
 